@@ -0,0 +1,17 @@
+﻿// Дворников Даниил ИВТ-22
+
+#include "search_bench_headers.h"
+
+int main(int argc, char* argv[])
+{
+    try {
+        run_search_bench(parse_args(argc, argv));
+    }
+    catch (const invalid_argument& err) {
+        cout << err.what() << '\n';
+        cout << "Usage: search_bench [--out file.csv] [--histogram file.csv] [--min-bytes 4K] [--max-bytes 1G]\n"
+            << "    [--max-linear-bytes 64M] [--queries N] [--cold-queries N] [--hit-ratios 1,0.5,0]\n"
+            << "    [--cache hot|cold|both] [--methods bin_search,eytzinger_index,...]\n";
+        return 1;
+    }
+}
@@ -0,0 +1,343 @@
+﻿// Дворников Даниил ИВТ-22
+
+#include "search_bench_headers.h"
+#include "../task_1/eytzinger_search.h"
+#include "../task_1/learned_index.h"
+#include "../task_1/simd_search.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <sstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+size_t latency_histogram::bucket_of(uint64_t value) {
+	// Значения меньше 2 * sub_buckets попадают каждое в свою часть
+	if (value < 2 * sub_buckets) return static_cast<size_t>(value);
+
+	unsigned e{};
+	while ((value >> (e + 1)) != 0) e++;
+	size_t sub = static_cast<size_t>((value >> (e - sub_bits)) & (sub_buckets - 1));
+	return ((e - sub_bits + 1) << sub_bits) + sub;
+}
+
+uint64_t latency_histogram::bucket_lower(size_t bucket) {
+	if (bucket < 2 * sub_buckets) return bucket;
+
+	unsigned e = static_cast<unsigned>(bucket >> sub_bits) + sub_bits - 1;
+	uint64_t sub = bucket & (sub_buckets - 1);
+	return (sub_buckets + sub) << (e - sub_bits);
+}
+
+uint64_t latency_histogram::bucket_upper(size_t bucket) {
+	if (bucket < 2 * sub_buckets) return bucket;
+
+	unsigned e = static_cast<unsigned>(bucket >> sub_bits) + sub_bits - 1;
+	return bucket_lower(bucket) + (uint64_t{ 1 } << (e - sub_bits)) - 1;
+}
+
+void latency_histogram::add(double ns) {
+	if (ns < 0) ns = 0;
+
+	counts_[bucket_of(static_cast<uint64_t>(std::llround(ns)))]++;
+	count_++;
+	sum_ += ns;
+	max_ = std::max(max_, ns);
+}
+
+double latency_histogram::percentile(double q) const {
+	if (count_ == 0) return 0.0;
+
+	// Номер измерения (с 1), которое должно попасть в часть
+	uint64_t rank = static_cast<uint64_t>(std::ceil(q * count_));
+	rank = std::max<uint64_t>(rank, 1);
+
+	uint64_t seen{};
+	for (size_t b{}; b < counts_.size(); b++) {
+		seen += counts_[b];
+		if (seen >= rank) return std::min(static_cast<double>(bucket_upper(b)), max_);
+	}
+
+	return max_;
+}
+
+void latency_histogram::write_csv(ostream& out, const string& prefix) const {
+	for (size_t b{}; b < counts_.size(); b++) {
+		if (counts_[b] != 0) {
+			out << prefix << ',' << bucket_lower(b) << ',' << bucket_upper(b) << ',' << counts_[b] << '\n';
+		}
+	}
+}
+
+vector<search_method> search_methods() {
+	return {
+		{ "incremental_search", true, [](const int* arr, size_t n) {
+			return function<long long(int)>([arr, n](int key) { return incremental_search(const_cast<int*>(arr), key, n); });
+		} },
+		{ "simd_incremental_search", true, [](const int* arr, size_t n) {
+			return function<long long(int)>([arr, n](int key) { return simd_incremental_search(arr, key, n); });
+		} },
+		{ "bin_search", false, [](const int* arr, size_t n) {
+			return function<long long(int)>([arr, n](int key) { return bin_search(const_cast<int*>(arr), key, n); });
+		} },
+		{ "eytzinger_index", false, [](const int* arr, size_t n) {
+			auto index = make_shared<eytzinger_index<int>>(arr, n);
+			return function<long long(int)>([index](int key) { return index->search(key); });
+		} },
+		{ "learned_index", false, [](const int* arr, size_t n) {
+			auto index = make_shared<learned_index<int>>(arr, n);
+			return function<long long(int)>([index, arr, n](int key) {
+				size_t pos = index->lower_bound(key);
+				return (pos < n && arr[pos] == key) ? static_cast<long long>(pos) : -1LL;
+			});
+		} },
+	};
+}
+
+/// Разбирает неотрицательное число; бросает invalid_argument, если text не число
+static double parse_number(const string& text, size_t* used) {
+	try {
+		double value = stod(text, used);
+		if (value < 0) throw invalid_argument(text);
+		return value;
+	}
+	catch (const logic_error&) {
+		// stod бросает invalid_argument или out_of_range
+		throw invalid_argument("Invalid number: " + text);
+	}
+}
+
+/// Разбирает целое неотрицательное число
+static size_t parse_count(const string& text) {
+	size_t used{};
+	double value = parse_number(text, &used);
+	if (used != text.size()) throw invalid_argument("Invalid number: " + text);
+
+	return static_cast<size_t>(value);
+}
+
+/// Разбирает размер в байтах с необязательным суффиксом K, M или G
+static size_t parse_size(const string& text) {
+	size_t used{};
+	double value = parse_number(text, &used);
+	string suffix = text.substr(used);
+
+	if (suffix == "K" || suffix == "k") value *= 1 << 10;
+	else if (suffix == "M" || suffix == "m") value *= 1 << 20;
+	else if (suffix == "G" || suffix == "g") value *= 1 << 30;
+	else if (!suffix.empty()) throw invalid_argument("Invalid size: " + text);
+
+	return static_cast<size_t>(value);
+}
+
+/// Делит строку text по запятым
+static vector<string> split_list(const string& text) {
+	vector<string> items;
+	stringstream stream(text);
+	string item;
+
+	while (getline(stream, item, ',')) {
+		if (!item.empty()) items.push_back(item);
+	}
+
+	return items;
+}
+
+bench_config parse_args(int argc, char* argv[]) {
+	bench_config config;
+
+	for (int i{ 1 }; i < argc; i++) {
+		string arg = argv[i];
+		if (i + 1 >= argc) throw invalid_argument("Missing value for " + arg);
+		string value = argv[++i];
+
+		if (arg == "--out") config.out_file = value;
+		else if (arg == "--histogram") config.histogram_file = value;
+		else if (arg == "--min-bytes") config.min_bytes = parse_size(value);
+		else if (arg == "--max-bytes") config.max_bytes = parse_size(value);
+		else if (arg == "--max-linear-bytes") config.max_linear_bytes = parse_size(value);
+		else if (arg == "--queries") config.queries = parse_count(value);
+		else if (arg == "--cold-queries") config.cold_queries = parse_count(value);
+		else if (arg == "--methods") config.methods = split_list(value);
+		else if (arg == "--hit-ratios") {
+			config.hit_ratios.clear();
+			for (const string& ratio : split_list(value)) {
+				size_t used{};
+				config.hit_ratios.push_back(parse_number(ratio, &used));
+			}
+		}
+		else if (arg == "--cache") {
+			config.hot = value == "hot" || value == "both";
+			config.cold = value == "cold" || value == "both";
+			if (!config.hot && !config.cold) throw invalid_argument("Invalid cache mode: " + value);
+		}
+		else throw invalid_argument("Unknown option " + arg);
+	}
+
+	if (config.queries == 0 || config.cold_queries == 0) throw invalid_argument("Query count must be positive");
+	if (config.min_bytes < 2 * sizeof(int) || config.min_bytes > config.max_bytes) throw invalid_argument("Invalid size range");
+	// Ключи 2i массива должны помещаться в int
+	if (config.max_bytes / sizeof(int) > static_cast<size_t>(numeric_limits<int>::max() / 2)) throw invalid_argument("Array size is too large");
+	for (double ratio : config.hit_ratios) {
+		if (ratio < 0 || ratio > 1) throw invalid_argument("Hit ratio must be between 0 and 1");
+	}
+
+	return config;
+}
+
+/// Размер кэша последнего уровня в байтах (32 МБ, если узнать не удалось)
+static size_t last_level_cache_bytes() {
+#if defined(_SC_LEVEL3_CACHE_SIZE)
+	long bytes = sysconf(_SC_LEVEL3_CACHE_SIZE);
+	if (bytes > 0) return static_cast<size_t>(bytes);
+#endif
+	return 32 << 20;
+}
+
+/// Вытесняет из кэша данные поиска чтением буфера вдвое больше кэша последнего уровня
+class cache_evictor {
+public:
+	cache_evictor() : buffer_(2 * last_level_cache_bytes(), 1) {}
+
+	void evict() {
+		unsigned sum{};
+		for (size_t i{}; i < buffer_.size(); i += 64) {
+			sum += buffer_[i];
+		}
+		sink_ = sum;
+	}
+
+private:
+	vector<unsigned char> buffer_;
+	volatile unsigned sink_{};
+};
+
+/// Возвращает медиану времени между двумя соседними вызовами steady_clock::now() в наносекундах
+static double timer_overhead_ns() {
+	latency_histogram histogram;
+
+	for (int i{}; i < 100'000; i++) {
+		const auto start_time{ steady_clock::now() };
+		const auto end_time{ steady_clock::now() };
+		histogram.add(duration<double, std::nano>(end_time - start_time).count());
+	}
+
+	return histogram.percentile(0.5);
+}
+
+/// Измеряет задержку каждого запроса keys; в режиме cold перед каждым запросом кэш вытесняется.
+/// Из каждого измерения вычитается время самого замера overhead_ns
+static latency_histogram measure(const function<long long(int)>& search, const vector<int>& keys, bool cold,
+	cache_evictor& evictor, double overhead_ns) {
+	latency_histogram histogram;
+	long long checksum{};
+
+	// В режиме горячего кэша запросы сначала выполняются без замера
+	if (!cold) {
+		for (int key : keys) {
+			checksum += search(key);
+		}
+	}
+
+	for (int key : keys) {
+		if (cold) evictor.evict();
+
+		const auto start_time{ steady_clock::now() };
+		checksum += search(key);
+		const auto end_time{ steady_clock::now() };
+
+		histogram.add(duration<double, std::nano>(end_time - start_time).count() - overhead_ns);
+	}
+
+	// Контрольная сумма не даёт компилятору выбросить поиск
+	if (checksum == 42) cout << "";
+	return histogram;
+}
+
+/// Возвращает count ключей для массива чётных чисел 0, 2, ..., 2(n - 1): доля hit_ratio из них
+/// присутствует в массиве (чётные), остальные - нет (нечётные внутри диапазона массива)
+static vector<int> make_keys(size_t n, size_t count, double hit_ratio, mt19937_64& gen) {
+	vector<int> keys(count);
+	size_t hits = static_cast<size_t>(std::llround(hit_ratio * count));
+	uniform_int_distribution<size_t> hit_pos(0, n - 1);
+	uniform_int_distribution<size_t> miss_pos(0, n - 2);
+
+	for (size_t i{}; i < count; i++) {
+		keys[i] = i < hits ? static_cast<int>(2 * hit_pos(gen)) : static_cast<int>(2 * miss_pos(gen) + 1);
+	}
+	shuffle(keys.begin(), keys.end(), gen);
+
+	return keys;
+}
+
+void run_search_bench(const bench_config& config) {
+	ofstream out(config.out_file);
+	if (!out.is_open()) throw invalid_argument("Access error - unable to create file");
+
+	ofstream histogram_out;
+	if (!config.histogram_file.empty()) {
+		histogram_out.open(config.histogram_file);
+		if (!histogram_out.is_open()) throw invalid_argument("Access error - unable to create file");
+		histogram_out << "method,array_bytes,cache,hit_ratio,lower_ns,upper_ns,count\n";
+	}
+
+	const double overhead_ns = timer_overhead_ns();
+	cache_evictor evictor;
+	mt19937_64 gen(2024);
+
+	out << "method,array_bytes,n,cache,hit_ratio,queries,build_ms,mean_ns,p50_ns,p99_ns,p999_ns,max_ns\n";
+	cout << "timer overhead " << overhead_ns << " ns, results in " << config.out_file << '\n';
+	cout << "method\tbytes\tcache\thit\tp50 ns\tp99 ns\tp999 ns\n";
+
+	vector<search_method> methods = search_methods();
+
+	for (size_t bytes{ config.min_bytes }; bytes <= config.max_bytes; bytes *= 4) {
+		const size_t n = bytes / sizeof(int);
+
+		// Отсортированный массив чётных чисел, общий для всех способов поиска
+		unique_ptr<int[]> arr(new int[n]);
+		for (size_t i{}; i < n; i++) {
+			arr[i] = static_cast<int>(2 * i);
+		}
+
+		for (const search_method& method : methods) {
+			if (!config.methods.empty() && find(config.methods.begin(), config.methods.end(), method.name) == config.methods.end()) continue;
+			if (method.linear && bytes > config.max_linear_bytes) continue;
+
+			const auto start_time{ steady_clock::now() };
+			function<long long(int)> search = method.build(arr.get(), n);
+			const duration<double, std::milli> build_ms{ steady_clock::now() - start_time };
+
+			// Для линейного поиска число запросов ограничено, чтобы замер занимал разумное время
+			size_t queries = config.queries;
+			if (method.linear) queries = std::clamp<size_t>(200'000'000 / n, 100, queries);
+
+			for (double hit_ratio : config.hit_ratios) {
+				for (bool cold : { false, true }) {
+					if ((cold && !config.cold) || (!cold && !config.hot)) continue;
+
+					const size_t count = cold ? std::min(queries, config.cold_queries) : queries;
+					vector<int> keys = make_keys(n, count, hit_ratio, gen);
+					latency_histogram histogram = measure(search, keys, cold, evictor, overhead_ns);
+					const char* cache = cold ? "cold" : "hot";
+
+					out << method.name << ',' << bytes << ',' << n << ',' << cache << ',' << hit_ratio << ',' << count << ','
+						<< build_ms.count() << ',' << histogram.mean() << ',' << histogram.percentile(0.5) << ','
+						<< histogram.percentile(0.99) << ',' << histogram.percentile(0.999) << ',' << histogram.max() << '\n';
+					cout << method.name << '\t' << bytes << '\t' << cache << '\t' << hit_ratio << '\t' << histogram.percentile(0.5) << '\t'
+						<< histogram.percentile(0.99) << '\t' << histogram.percentile(0.999) << '\n';
+
+					if (histogram_out.is_open()) {
+						ostringstream prefix;
+						prefix << method.name << ',' << bytes << ',' << cache << ',' << hit_ratio;
+						histogram.write_csv(histogram_out, prefix.str());
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,92 @@
+﻿// Дворников Даниил ИВТ-22
+
+#pragma once
+
+#include "../task_1/arr_alg_headers.h"
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <vector>
+
+/// Гистограмма задержек в наносекундах: каждый отрезок [2^e, 2^(e+1)) делится на 16 равных частей,
+/// поэтому процентили определяются с относительной погрешностью не больше 1/16
+class latency_histogram {
+public:
+	/// Добавляет измерение ns
+	void add(double ns);
+
+	/// Возвращает верхнюю границу части, в которую попадает доля q (от 0 до 1) измерений
+	double percentile(double q) const;
+
+	/// Количество измерений
+	size_t count() const {
+		return count_;
+	}
+
+	/// Среднее значение измерений
+	double mean() const {
+		return count_ == 0 ? 0.0 : sum_ / count_;
+	}
+
+	/// Наибольшее измерение
+	double max() const {
+		return max_;
+	}
+
+	/// Выводит непустые части гистограммы строками "prefix,нижняя граница,верхняя граница,количество"
+	void write_csv(ostream& out, const string& prefix) const;
+
+private:
+	static constexpr unsigned sub_bits = 4;
+	static constexpr size_t sub_buckets = size_t{ 1 } << sub_bits;
+
+	/// Номер части для значения value
+	static size_t bucket_of(uint64_t value);
+	/// Наименьшее значение части bucket
+	static uint64_t bucket_lower(size_t bucket);
+	/// Наибольшее значение части bucket
+	static uint64_t bucket_upper(size_t bucket);
+
+	vector<uint64_t> counts_ = vector<uint64_t>(64 * sub_buckets);
+	size_t count_{};
+	double sum_{};
+	double max_{};
+};
+
+/// Способ поиска: по отсортированному массиву строит функцию, возвращающую индекс ключа или -1
+struct search_method {
+	string name;
+	/// Время запроса растёт линейно с размером массива (такие способы не запускаются на самых больших массивах)
+	bool linear;
+	function<function<long long(int)>(const int* arr, size_t n)> build;
+};
+
+/// Возвращает все способы поиска; новый индекс добавляется сюда одной записью
+vector<search_method> search_methods();
+
+/// Параметры запуска
+struct bench_config {
+	string out_file = "search_bench.csv";
+	/// Файл для гистограмм (пусто - не записываются)
+	string histogram_file;
+	size_t min_bytes = 4 << 10;
+	size_t max_bytes = size_t{ 1 } << 30;
+	/// Наибольший размер массива для способов с линейным временем запроса
+	size_t max_linear_bytes = 64 << 20;
+	size_t queries = 100'000;
+	/// Запросов в режиме холодного кэша: перед каждым запросом кэш вытесняется, это долго
+	size_t cold_queries = 200;
+	vector<double> hit_ratios{ 1.0, 0.5, 0.0 };
+	bool hot = true;
+	bool cold = true;
+	/// Названия способов поиска (пусто - все)
+	vector<string> methods;
+};
+
+/// Разбирает аргументы командной строки; бросает invalid_argument при ошибке
+bench_config parse_args(int argc, char* argv[]);
+
+/// Выполняет замеры для всех размеров массива, способов поиска, долей попаданий и состояний кэша
+/// и записывает результаты в CSV
+void run_search_bench(const bench_config& config);
@@ -0,0 +1,262 @@
+﻿// Дворников Даниил ИВТ-22
+
+#include "arr_alg_headers.h"
+#include "eytzinger_search.h"
+#include "simd_search.h"
+#include "batch_search.h"
+#include "learned_index.h"
+
+#include <algorithm>
+#include <vector>
+
+/// Возвращает среднее время одного вызова search(key) в наносекундах для ключей keys
+template<class Search> double time_per_lookup(const vector<int>& keys, Search search) {
+	long long checksum{};
+	const auto start_time{ steady_clock::now() };
+
+	for (int key : keys) {
+		checksum += search(key);
+	}
+
+	const auto end_time{ steady_clock::now() };
+	const duration<double, std::nano> elapsed_ns{ end_time - start_time };
+
+	// Контрольная сумма не даёт компилятору выбросить поиск
+	if (checksum == 42) cout << "";
+	return elapsed_ns.count() / keys.size();
+}
+
+/// Сравнивает bin_search и eytzinger_index на массивах от размера кэша L1 до размеров больше кэша последнего уровня
+void bench_search_index() {
+	const size_t lookups = 1'000'000;
+	mt19937 gen(12345);
+
+	// Наибольший массив - 2^26 чисел (256 МБ), что в несколько раз больше кэша последнего уровня;
+	// вместе с индексом (12 байт на элемент) тест занимает около 1 ГБ памяти
+	const size_t max_size = size_t(1) << 26;
+
+	cout << "size\tbytes\tbin_search ns\teytzinger ns\n";
+	for (size_t n = 1 << 10; n <= max_size; n <<= 2) {
+		// Отсортированный массив чётных чисел: чётные ключи находятся, нечётные - нет
+		int* a = new int[n];
+		for (size_t i{}; i < n; i++) {
+			a[i] = static_cast<int>(2 * i);
+		}
+
+		vector<int> keys(lookups);
+		uniform_int_distribution<int> dis(0, static_cast<int>(2 * (n - 1)));
+		for (int& key : keys) {
+			key = dis(gen);
+		}
+
+		eytzinger_index<int> index(a, n);
+
+		double bin_ns = time_per_lookup(keys, [&](int key) { return bin_search(a, key, n); });
+		double eytz_ns = time_per_lookup(keys, [&](int key) { return index.search(key); });
+
+		cout << n << "\t" << n * sizeof(int) << "\t" << bin_ns << "\t" << eytz_ns << '\n';
+
+		delete[] a;
+	}
+}
+
+/// Возвращает среднее время одного вызова search() в миллисекундах за iter повторов
+template<class Search> double time_per_scan(int iter, Search search) {
+	long long checksum{};
+	const auto start_time{ steady_clock::now() };
+
+	for (int j{}; j < iter; j++) {
+		checksum += search();
+	}
+
+	const auto end_time{ steady_clock::now() };
+	const duration<double, std::milli> elapsed_ms{ end_time - start_time };
+
+	if (checksum == 42) cout << "";
+	return elapsed_ms.count() / iter;
+}
+
+/// Сравнивает incremental_search, simd_incremental_search и parallel_incremental_search:
+/// ключ в начале массива (лучший случай), в середине (средний) и отсутствующий ключ (худший)
+void bench_incremental_search() {
+	const size_t n = 1 << 26;
+	const int iter = 10;
+	const size_t threads = std::max(1u, std::thread::hardware_concurrency());
+
+	// Значения массива неотрицательны, поэтому ключ -1 не найдётся
+	int* a = new int[n];
+	fill_arr_rand(a, n, 1'000'000, 0);
+
+	struct scenario { const char* name; size_t pos; };
+	const scenario cases[]{ { "best", 0 }, { "average", n / 2 }, { "worst", n } };
+
+	// Ключ читается через volatile, чтобы компилятор не вынес поиск из цикла замера
+	volatile int key = -1;
+
+	cout << "case\tincremental ms\tsimd ms\tparallel ms (" << threads << " threads)\n";
+	for (const scenario& sc : cases) {
+		if (sc.pos < n) a[sc.pos] = key;
+
+		double plain_ms = time_per_scan(iter, [&]() { return incremental_search(a, static_cast<int>(key), n); });
+		double simd_ms = time_per_scan(iter, [&]() { return simd_incremental_search(a, static_cast<int>(key), n); });
+		double par_ms = time_per_scan(iter, [&]() { return parallel_incremental_search(a, static_cast<int>(key), n, threads); });
+
+		cout << sc.name << "\t" << plain_ms << "\t" << simd_ms << "\t" << par_ms << '\n';
+
+		if (sc.pos < n) a[sc.pos] = 0;
+	}
+
+	delete[] a;
+}
+
+/// Сравнивает поиск k ключей отдельными вызовами и одним пакетным вызовом
+/// для неотсортированного (incremental_search) и отсортированного (bin_search) массивов
+void bench_batch_search() {
+	const size_t n = 1'000'000;
+	mt19937 gen(777);
+
+	int* a = new int[n];
+	fill_arr_rand(a, n, 1'000'000, 0);
+	int* sorted = new int[n];
+	copy(a, a + n, sorted);
+	sort(sorted, sorted + n);
+
+	cout << "keys\tincremental ms\tbatch_incremental ms\tbin_search ms\tbatch_bin ms\n";
+	for (size_t k : { 10, 100, 1000, 100'000 }) {
+		vector<int> keys(k);
+		uniform_int_distribution<int> dis(0, 1'000'000);
+		for (int& key : keys) {
+			key = dis(gen);
+		}
+
+		// Отдельные последовательные поиски для большого числа ключей слишком долгие
+		double plain_ms = -1;
+		if (k <= 1000) {
+			plain_ms = time_per_scan(1, [&]() {
+				long long sum{};
+				for (int key : keys) sum += incremental_search(a, key, n);
+				return sum;
+			});
+		}
+		double batch_ms = time_per_scan(3, [&]() { return batch_incremental_search(a, keys, n)[0]; });
+		double bin_ms = time_per_scan(3, [&]() {
+			long long sum{};
+			for (int key : keys) sum += bin_search(sorted, key, n);
+			return sum;
+		});
+		double batch_bin_ms = time_per_scan(3, [&]() { return batch_bin_search(sorted, keys, n)[0]; });
+
+		cout << k << "\t" << plain_ms << "\t" << batch_ms << "\t" << bin_ms << "\t" << batch_bin_ms << '\n';
+	}
+
+	delete[] sorted;
+	delete[] a;
+}
+
+/// Сравнивает поиск нижней границы обученным индексом с std::lower_bound и bin_search,
+/// а также время построения индекса и его объём относительно массива
+void bench_learned_index() {
+	const size_t lookups = 1'000'000;
+	mt19937 gen(4242);
+
+	cout << "size\tsegments\tindex bytes\tarray bytes\tbuild ms\tlower_bound ns\tlearned ns\tbin_search ns\n";
+	for (size_t n = 1 << 16; n <= (1 << 26); n <<= 2) {
+		// Отсортированный массив со случайными промежутками между соседними ключами
+		int* a = new int[n];
+		uniform_int_distribution<int> gap(0, 20);
+		int value{};
+		for (size_t i{}; i < n; i++) {
+			value += gap(gen);
+			a[i] = value;
+		}
+
+		vector<int> keys(lookups);
+		uniform_int_distribution<int> dis(0, value);
+		for (int& key : keys) {
+			key = dis(gen);
+		}
+
+		const auto start_time{ steady_clock::now() };
+		learned_index<int> index(a, n);
+		const duration<double, std::milli> build_ms{ steady_clock::now() - start_time };
+
+		double std_ns = time_per_lookup(keys, [&](int key) { return static_cast<long long>(lower_bound(a, a + n, key) - a); });
+		double learned_ns = time_per_lookup(keys, [&](int key) { return static_cast<long long>(index.lower_bound(key)); });
+		double bin_ns = time_per_lookup(keys, [&](int key) { return bin_search(a, key, n); });
+
+		cout << n << "\t" << index.segment_count() << "\t" << index.memory_bytes() << "\t" << index.array_bytes() << "\t"
+			<< build_ms.count() << "\t" << std_ns << "\t" << learned_ns << "\t" << bin_ns << '\n';
+
+		delete[] a;
+	}
+}
+
+/// Сравнивает потоковые и быстрые запись и чтение массива из 10 млн чисел double
+void bench_text_io() {
+	const size_t n = 10'000'000;
+	const string file_name = "bench_text_io.txt";
+
+	double* a = new double[n];
+	fill_arr_rand(a, n, 1e6, 0);
+
+	auto time_ms = [](auto action) {
+		const auto start_time{ steady_clock::now() };
+		action();
+		const duration<double, std::milli> elapsed_ms{ steady_clock::now() - start_time };
+		return elapsed_ms.count();
+	};
+
+	double* b{};
+	double stream_save = time_ms([&]() { f_save_arr_stream(a, file_name, n); });
+	double stream_read = time_ms([&]() { b = f_read_arr_stream(b, file_name, n); });
+	delete[] b;
+	double fast_save = time_ms([&]() { f_save_arr(a, file_name, n); });
+	double fast_read = time_ms([&]() { b = f_read_arr(b, file_name, n); });
+	delete[] b;
+
+	cout << "values\tstream save ms\tstream read ms\tfast save ms\tfast read ms\n";
+	cout << n << "\t" << stream_save << "\t" << stream_read << "\t" << fast_save << "\t" << fast_read << '\n';
+
+	remove(file_name.c_str());
+	delete[] a;
+}
+
+/// Сравнивает pdq_sort с bubble_sort и std::sort на случайных, упорядоченных, обратных массивах и массивах с повторами
+void bench_sort() {
+	mt19937 gen(31337);
+
+	auto time_ms = [](int* arr, size_t n, auto sort_function) {
+		const auto start_time{ steady_clock::now() };
+		sort_function(arr, n);
+		const duration<double, std::milli> elapsed_ms{ steady_clock::now() - start_time };
+		assert(is_sorted_up(arr, n));
+		return elapsed_ms.count();
+	};
+
+	cout << "pattern\tsize\tbubble_sort ms\tstd::sort ms\tpdq_sort ms\n";
+	for (size_t n : { 10'000, 1'000'000, 10'000'000 }) {
+		const char* patterns[]{ "random", "sorted", "reversed", "few_unique" };
+		for (size_t p{}; p < 4; p++) {
+			vector<int> input(n);
+			for (size_t i{}; i < n; i++) {
+				switch (p) {
+				case 0: input[i] = static_cast<int>(gen()); break;
+				case 1: input[i] = static_cast<int>(i); break;
+				case 2: input[i] = static_cast<int>(n - i); break;
+				default: input[i] = static_cast<int>(gen() % 16); break;
+				}
+			}
+
+			// Пузырьковая сортировка измеряется только на малом массиве
+			double bubble_ms = -1;
+			vector<int> work = input;
+			if (n <= 10'000) bubble_ms = time_ms(work.data(), n, [](int* arr, size_t m) { bubble_sort(arr, m); });
+			work = input;
+			double std_ms = time_ms(work.data(), n, [](int* arr, size_t m) { sort(arr, arr + m); });
+			work = input;
+			double pdq_ms = time_ms(work.data(), n, [](int* arr, size_t m) { pdq_sort(arr, m); });
+
+			cout << patterns[p] << "\t" << n << "\t" << bubble_ms << "\t" << std_ms << "\t" << pdq_ms << '\n';
+		}
+	}
+}
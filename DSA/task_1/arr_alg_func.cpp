@@ -1,6 +1,10 @@
 ﻿// Дворников Даниил ИВТ-22
 
 #include "arr_alg_headers.h"
+#include "eytzinger_search.h"
+#include "simd_search.h"
+#include "batch_search.h"
+#include "learned_index.h"
 
 /// Тестирует функции
 void test() {
@@ -69,6 +73,235 @@ void test() {
 	bubble_sort(a, n);
 	assert(static_cast<int>(is_sorted_up(a, n)) == true);
 
+	{ /// тест индекса Эйтцингера
+		eytzinger_index<double> index(a, n);
+		assert(index.search(1.1) == 0);
+		assert(index.search(3.3) == 2);
+		assert(index.search(5.5) == 4);
+		assert(index.search(0.0) == -1);
+		assert(index.search(2.5) == -1);
+		assert(index.search(6.0) == -1);
+
+		size_t m{ 1000 };
+		int* c = new int[m];
+		for (size_t i{}; i < m; i++) {
+			c[i] = static_cast<int>(i / 3);
+		}
+
+		eytzinger_index<int> int_index(c, m);
+		for (int key{ -1 }; key <= 340; key++) {
+			assert(int_index.search(key) == ((key >= 0 && key < 334) ? 3 * key : -1));
+		}
+
+		delete[] c;
+	}
+
+	{ /// тест векторного и многопоточного последовательного поиска
+		assert(simd_incremental_search(a, 1.1, n) == 0);
+		assert(simd_incremental_search(a, 3.3, n) == 2);
+		assert(simd_incremental_search(a, 5.5, n) == 4);
+		assert(simd_incremental_search(a, 0.0, n) == -1);
+
+		size_t m{ 1'000'003 };
+		int* c = new int[m];
+		float* f = new float[m];
+		for (size_t i{}; i < m; i++) {
+			c[i] = static_cast<int>(i % 500'000);
+			f[i] = static_cast<float>(i % 1000) / 4;
+		}
+
+		const int keys[]{ 0, 1, 7, 31, 32, 33, 255, 499'999, 12'345, -1, 500'000 };
+		for (int key : keys) {
+			long long expected = incremental_search(c, key, m);
+			assert(simd_incremental_search(c, key, m) == expected);
+			assert(parallel_incremental_search(c, key, m, 4) == expected);
+			assert(parallel_incremental_search(c, key, m, 1) == expected);
+		}
+		// Единственное вхождение в последнем элементе
+		c[m - 1] = -7;
+		assert(parallel_incremental_search(c, -7, m, 3) == static_cast<long long>(m - 1));
+
+		for (float key : { 0.0f, 0.25f, 249.75f, 100.5f, -1.0f, 250.0f }) {
+			long long expected = incremental_search(f, key, m);
+			assert(simd_incremental_search(f, key, m) == expected);
+			assert(parallel_incremental_search(f, key, m, 4) == expected);
+		}
+
+		delete[] f;
+		delete[] c;
+	}
+
+	{ /// тест пакетного поиска
+		size_t m{ 100'000 };
+		int* c = new int[m];
+		fill_arr_rand(c, m, 50'000, 0);
+
+		vector<int> keys;
+		for (int key{ -3 }; key < 50'003; key += 97) {
+			keys.push_back(key);
+		}
+		keys.push_back(keys[5]); // повторяющийся ключ
+
+		vector<long long> found = batch_incremental_search(c, keys, m);
+		for (size_t i{}; i < keys.size(); i++) {
+			assert(found[i] == incremental_search(c, keys[i], m));
+		}
+
+		sort(c, c + m);
+		// Мало ключей - одновременные бинарные поиски, много ключей - слияние с массивом
+		vector<int> few(keys.begin(), keys.begin() + 20);
+		vector<long long> found_few = batch_bin_search(c, few, m);
+		for (size_t i{}; i < few.size(); i++) {
+			assert(found_few[i] == incremental_search(c, few[i], m));
+		}
+
+		found = batch_bin_search(c, keys, m);
+		for (size_t i{}; i < keys.size(); i++) {
+			assert(found[i] == incremental_search(c, keys[i], m));
+		}
+
+		vector<double> dkeys{ 5.5, 0.0, 1.1, 3.3, 4.0 };
+		vector<long long> dfound = batch_bin_search(a, dkeys, n);
+		assert(dfound == vector<long long>({ 4, -1, 0, 2, -1 }));
+		assert(batch_incremental_search(a, dkeys, n) == dfound);
+		assert(batch_bin_search(a, dkeys, 0) == vector<long long>(dkeys.size(), -1));
+
+		delete[] c;
+	}
+
+	{ /// тест обученного индекса
+		size_t m{ 300'000 };
+		int* c = new int[m];
+		fill_arr_rand(c, m, 100'000, 0);
+		sort(c, c + m);
+		// Длинная серия повторов, после которой отсутствующий ключ окажется далеко от прогноза
+		for (size_t i{ 1000 }; i < 5000; i++) {
+			c[i] = c[1000];
+		}
+
+		learned_index<int> index(c, m, 8, 3);
+		assert(index.size() == m);
+		assert(index.segment_count() > 0);
+		for (int key{ -2 }; key <= 100'002; key += 7) {
+			assert(index.lower_bound(key) == static_cast<size_t>(lower_bound(c, c + m, key) - c));
+			assert(index.upper_bound(key) == static_cast<size_t>(upper_bound(c, c + m, key) - c));
+		}
+		assert(index.lower_bound(c[1000] + 1) == static_cast<size_t>(upper_bound(c, c + m, c[1000]) - c));
+		assert(index.count_in_range(c[1000], c[1000]) == static_cast<size_t>(count(c, c + m, c[1000])));
+		assert(index.count_in_range(-10, 200'000) == m);
+		assert(index.count_in_range(5, 4) == 0);
+
+		learned_index<double> small(a, n);
+		assert(small.lower_bound(3.3) == 2);
+		assert(small.upper_bound(3.3) == 3);
+		assert(small.count_in_range(2.0, 4.4) == 3);
+		assert(small.lower_bound(6.0) == n);
+
+		learned_index<int> empty(c, 0);
+		assert(empty.lower_bound(1) == 0 && empty.count_in_range(0, 10) == 0);
+
+		delete[] c;
+	}
+
+	{ /// тест быстрого текстового ввода-вывода
+		size_t m{ 200'000 };
+		int* c = new int[m];
+		double* d = new double[m];
+		fill_arr_rand(c, m, 1'000'000, -1'000'000);
+		fill_arr_rand(d, m, 1e6, -1e-3);
+		d[0] = 1e-300; d[1] = -0.0; d[2] = 123456789.0;
+
+		// Быстрая запись совпадает побайтно с потоковой
+		auto read_all = [](const string& name) {
+			ifstream file(name, ios::binary);
+			return string(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+		};
+		fast_save_arr(c, "test_fast_int.txt", m, 4);
+		f_save_arr_stream(c, "test_stream_int.txt", m);
+		assert(read_all("test_fast_int.txt") == read_all("test_stream_int.txt"));
+		f_save_arr(d, "test_fast_double.txt", m);
+		f_save_arr_stream(d, "test_stream_double.txt", m);
+		assert(read_all("test_fast_double.txt") == read_all("test_stream_double.txt"));
+
+		int* c_read = f_read_arr<int>(nullptr, "test_fast_int.txt", 0);
+		assert(equal(c, c + m, c_read));
+		double* d_fast = f_read_arr<double>(nullptr, "test_fast_double.txt", 0);
+		double* d_stream = f_read_arr_stream<double>(nullptr, "test_stream_double.txt", 0);
+		assert(equal(d_fast, d_fast + m, d_stream));
+
+		size_t read_n{};
+		delete[] fast_read_arr<int>("test_fast_int.txt", read_n, 4);
+		assert(read_n == m);
+
+		bool thrown{};
+		try {
+			f_read_arr<int>(nullptr, "no_such_file.txt", 0);
+		}
+		catch (const invalid_argument&) {
+			thrown = true;
+		}
+		assert(thrown);
+
+		delete[] d_stream;
+		delete[] d_fast;
+		delete[] c_read;
+		delete[] d;
+		delete[] c;
+		for (const char* name : { "test_fast_int.txt", "test_stream_int.txt", "test_fast_double.txt", "test_stream_double.txt" }) {
+			remove(name);
+		}
+	}
+
+	{ /// тест сортировки pdq_sort
+		pdq_sort(a, n);
+		assert(is_sorted_up(a, n));
+
+		mt19937 gen(2024);
+		for (size_t m : { 0, 1, 2, 23, 24, 25, 129, 1000, 100'000 }) {
+			vector<vector<int>> inputs(6, vector<int>(m));
+			for (size_t i{}; i < m; i++) {
+				inputs[0][i] = static_cast<int>(gen());                       // случайные
+				inputs[1][i] = static_cast<int>(i);                           // упорядоченные
+				inputs[2][i] = static_cast<int>(m - i);                       // обратный порядок
+				inputs[3][i] = 7;                                             // одинаковые
+				inputs[4][i] = static_cast<int>(gen() % 4);                   // мало различных
+				inputs[5][i] = static_cast<int>(i < m / 2 ? i : m - i);       // "пирамида"
+			}
+
+			for (vector<int>& input : inputs) {
+				vector<int> expected = input;
+				sort(expected.begin(), expected.end());
+				vector<int> heap = input;
+
+				pdq_sort(input.data(), m);
+				assert(input == expected);
+				heap_sort(heap.data(), m);
+				assert(heap == expected);
+			}
+		}
+
+		// Неарифметический тип сортируется разбиением с ветвлениями
+		vector<string> words{ "delta", "alpha", "echo", "bravo", "charlie", "alpha" };
+		for (int i{}; i < 6; i++) {
+			words.insert(words.end(), words.begin(), words.end());
+		}
+		vector<string> expected_words = words;
+		sort(expected_words.begin(), expected_words.end());
+		pdq_sort(words.data(), words.size());
+		assert(words == expected_words);
+
+		size_t m{ 100'000 };
+		double* d = new double[m];
+		fill_arr_rand(d, m, 1e3, -1e3);
+		pdq_sort(d, m);
+		assert(is_sorted_up(d, m));
+		delete[] d;
+
+		int c[]{ 5, 1, 4, 2, 3 };
+		bubble_sort(c, 5);
+		assert(is_sorted_up(c, 5));
+	}
+
 	delete[] b;
 	delete[] a;
 }
@@ -14,6 +14,9 @@
 //#define NDEBUG
 #include <cassert>
 
+#include "fast_io.h"
+#include "pdq_sort.h"
+
 using namespace std::chrono;
 using std::size_t;
 using namespace std;
@@ -39,8 +42,8 @@ template<class Arr_type> void print_arr(Arr_type arr[], size_t n) {
 	cout << endl;
 }
 
-/// Читает данные из файла file_name в массив arr и размерность n
-template<class Arr_type> Arr_type* f_read_arr(Arr_type arr[], const string& file_name, size_t n) {
+/// Читает данные из файла file_name в массив arr и размерность n через поток ifstream
+template<class Arr_type> Arr_type* f_read_arr_stream(Arr_type arr[], const string& file_name, size_t n) {
 	ifstream file_read(file_name);
 	//Arr_type* a;
 
@@ -62,8 +65,8 @@ template<class Arr_type> Arr_type* f_read_arr(Arr_type arr[], const string& file
 	return arr;
 }
 
-/// Записывает данные в файл file_name из массив arr и размерности n
-template<class Arr_type> void f_save_arr(Arr_type arr[], const string& file_name, size_t n) {
+/// Записывает данные в файл file_name из массив arr и размерности n через поток ofstream
+template<class Arr_type> void f_save_arr_stream(Arr_type arr[], const string& file_name, size_t n) {
 	ofstream file_write(file_name);
 
 	if (file_write.is_open()) {
@@ -80,6 +83,28 @@ template<class Arr_type> void f_save_arr(Arr_type arr[], const string& file_name
 	file_write.close();
 }
 
+/// Читает данные из файла file_name в массив arr и размерность n
+/// (числовые типы разбираются параллельно из отображённого в память файла, см. fast_read_arr)
+template<class Arr_type> Arr_type* f_read_arr(Arr_type arr[], const string& file_name, size_t n) {
+	if constexpr (is_text_number_v<Arr_type>) {
+		return fast_read_arr<Arr_type>(file_name, n);
+	}
+	else {
+		return f_read_arr_stream(arr, file_name, n);
+	}
+}
+
+/// Записывает данные в файл file_name из массив arr и размерности n
+/// (числовые типы переводятся в текст параллельно, см. fast_save_arr)
+template<class Arr_type> void f_save_arr(Arr_type arr[], const string& file_name, size_t n) {
+	if constexpr (is_text_number_v<Arr_type>) {
+		fast_save_arr(arr, file_name, n);
+	}
+	else {
+		f_save_arr_stream(arr, file_name, n);
+	}
+}
+
 /// Возвращает индекс найденного числа value в массиве arr размера n, либо -1, если число не найдено (последовательный поиск best - O(1), average - O(n), worst - O(n))
 template<class Arr_type> long long incremental_search(Arr_type arr[], Arr_type key, size_t n) {
 	for (size_t i{}; i < n; i++) {
@@ -152,4 +177,22 @@ template<class Arr_type> void bubble_sort(Arr_type arr[], size_t n) {
 }
 
 /// Тестирует функции
-void test();
\ No newline at end of file
+void test();
+
+/// Сравнивает bin_search и eytzinger_index на массивах разного размера
+void bench_search_index();
+
+/// Сравнивает incremental_search с векторной и многопоточной версиями в лучшем, среднем и худшем случаях
+void bench_incremental_search();
+
+/// Сравнивает повторные вызовы incremental_search и bin_search с пакетным поиском набора ключей
+void bench_batch_search();
+
+/// Сравнивает learned_index с std::lower_bound и bin_search и выводит объём памяти индекса
+void bench_learned_index();
+
+/// Сравнивает потоковые и быстрые f_save_arr / f_read_arr на большом массиве
+void bench_text_io();
+
+/// Сравнивает pdq_sort с bubble_sort и std::sort на массивах с разной закономерностью
+void bench_sort();
\ No newline at end of file
@@ -2,10 +2,21 @@
 
 #include "arr_alg_headers.h"
 
-int main()
+int main(int argc, char* argv[])
 {
     test();
 
+    // Запуск с аргументом bench выполняет сравнительные замеры
+    if (argc > 1 && string(argv[1]) == "bench") {
+        bench_search_index();
+        bench_incremental_search();
+        bench_batch_search();
+        bench_learned_index();
+        bench_text_io();
+        bench_sort();
+        return 0;
+    }
+
     srand(time(NULL));
     
     
@@ -0,0 +1,139 @@
+﻿// Дворников Даниил ИВТ-22
+
+#pragma once
+
+#include "eytzinger_search.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <unordered_map>
+#include <vector>
+
+/// Число различных ключей, до которого элементы сравниваются с ключами подряд без хеш-таблицы
+const size_t small_batch = 16;
+
+/// Возвращает для каждого ключа keys индекс его первого вхождения в неотсортированный массив arr размера n, либо -1.
+/// Массив просматривается один раз: каждый элемент проверяется по хеш-таблице ключей (O(n + k) вместо O(n * k))
+template<class Arr_type> std::vector<long long> batch_incremental_search(const Arr_type arr[], const std::vector<Arr_type>& keys, size_t n) {
+	std::vector<long long> result(keys.size(), -1);
+	if (keys.empty()) return result;
+
+	// Одинаковые ключи получают общую ячейку, чтобы поиск закончился, когда найдены все различные ключи
+	std::unordered_map<Arr_type, size_t> slot;
+	slot.reserve(keys.size());
+	std::vector<size_t> key_slot(keys.size());
+	std::vector<long long> first;
+
+	// Границы ключей отсекают большую часть элементов без обращения к хеш-таблице
+	Arr_type lower{ keys[0] }, upper{ keys[0] };
+
+	for (size_t i{}; i < keys.size(); i++) {
+		auto [it, inserted] = slot.try_emplace(keys[i], first.size());
+		if (inserted) first.push_back(-1);
+		key_slot[i] = it->second;
+
+		if (keys[i] < lower) lower = keys[i];
+		if (upper < keys[i]) upper = keys[i];
+	}
+
+	size_t remaining{ first.size() };
+
+	if (first.size() <= small_batch) {
+		// Несколько различных ключей дешевле сравнить подряд, чем вычислять хеш каждого элемента
+		std::vector<Arr_type> unique(first.size());
+		for (const auto& [key, s] : slot) {
+			unique[s] = key;
+		}
+
+		for (size_t i{}; i < n && remaining > 0; i++) {
+			if (arr[i] < lower || upper < arr[i]) continue;
+
+			for (size_t s{}; s < unique.size(); s++) {
+				if (arr[i] == unique[s] && first[s] < 0) {
+					first[s] = i;
+					remaining--;
+				}
+			}
+		}
+	}
+	else {
+		for (size_t i{}; i < n && remaining > 0; i++) {
+			if (arr[i] < lower || upper < arr[i]) continue;
+
+			auto it = slot.find(arr[i]);
+			if (it != slot.end() && first[it->second] < 0) {
+				first[it->second] = i;
+				remaining--;
+			}
+		}
+	}
+
+	for (size_t i{}; i < keys.size(); i++) {
+		result[i] = first[key_slot[i]];
+	}
+
+	return result;
+}
+
+/// Возвращает для каждого ключа keys индекс его первого вхождения в отсортированный по возрастанию массив arr размера n, либо -1.
+/// При большом числе ключей они сортируются и массив проходится один раз вместе с ними (O(n + k log k)),
+/// иначе ключи ищутся группами: бинарные поиски группы идут в ногу, и загрузки из памяти для разных ключей перекрываются
+template<class Arr_type> std::vector<long long> batch_bin_search(const Arr_type arr[], const std::vector<Arr_type>& keys, size_t n) {
+	std::vector<long long> result(keys.size(), -1);
+	if (keys.empty() || n == 0) return result;
+
+	// Ключи, не равные сами себе (NaN), не найдутся и не участвуют в сортировке
+	std::vector<size_t> order;
+	order.reserve(keys.size());
+	for (size_t i{}; i < keys.size(); i++) {
+		if (keys[i] == keys[i]) order.push_back(i);
+	}
+
+	if (static_cast<double>(order.size()) * std::log2(static_cast<double>(n) + 1) > static_cast<double>(n)) {
+		// Слияние отсортированных ключей с массивом
+		std::stable_sort(order.begin(), order.end(), [&keys](size_t l, size_t r) { return keys[l] < keys[r]; });
+
+		size_t i{};
+		for (size_t k : order) {
+			while (i < n && arr[i] < keys[k]) i++;
+			if (i < n && arr[i] == keys[k]) result[k] = i;
+		}
+
+		return result;
+	}
+
+	// Число одновременно выполняемых бинарных поисков
+	const size_t group = 16;
+	const Arr_type* base[group];
+
+	for (size_t g_start{}; g_start < order.size(); g_start += group) {
+		const size_t g_size = std::min(group, order.size() - g_start);
+		const size_t* idx = order.data() + g_start;
+
+		for (size_t g{}; g < g_size; g++) {
+			base[g] = arr;
+		}
+
+		// Длина отрезка поиска зависит только от n, поэтому у всех ключей группы шаги совпадают
+		size_t len{ n };
+		while (len > 1) {
+			const size_t half = len / 2;
+			const size_t next_half = (len - half) / 2;
+
+			for (size_t g{}; g < g_size; g++) {
+				base[g] = (base[g][half] < keys[idx[g]]) ? base[g] + half : base[g];
+				prefetch_read(base[g] + next_half);
+			}
+			len -= half;
+		}
+
+		for (size_t g{}; g < g_size; g++) {
+			const Arr_type* pos = base[g] + (*base[g] < keys[idx[g]]);
+			if (pos < arr + n && *pos == keys[idx[g]]) result[idx[g]] = pos - arr;
+		}
+	}
+
+	return result;
+}
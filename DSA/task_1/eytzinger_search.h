@@ -0,0 +1,121 @@
+﻿// Дворников Даниил ИВТ-22
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <memory>
+#include <type_traits>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/// Подсказывает процессору загрузить строку кэша с адресом p
+inline void prefetch_read(const void* p) {
+#if defined(_MSC_VER)
+	_mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+	__builtin_prefetch(p);
+#endif
+}
+
+/// Возвращает номер младшего нулевого бита x, считая с 1 (x не равен ~0)
+inline unsigned lowest_zero_bit(uint64_t x) {
+#if defined(_MSC_VER)
+	unsigned long pos;
+	_BitScanForward64(&pos, ~x);
+	return pos + 1;
+#else
+	return __builtin_ffsll(static_cast<long long>(~x));
+#endif
+}
+
+/// Индекс поиска по отсортированному массиву в порядке Эйтцингера (обход дерева в ширину).
+/// Узел k имеет потомков 2k и 2k + 1, поэтому спуск идёт без ветвлений, а потомки
+/// на несколько уровней вперёд лежат в одной строке кэша и загружаются заранее.
+template<class Arr_type> class eytzinger_index {
+	// Память под ключи выделяется без конструирования и заполняется присваиванием
+	static_assert(std::is_trivially_copyable_v<Arr_type>, "eytzinger_index requires a trivially copyable key type");
+
+public:
+	/// Строит индекс по массиву arr размера n, отсортированному по возрастанию
+	eytzinger_index(const Arr_type arr[], size_t n) : n_(n), keys_(allocate<Arr_type>(n + 1)), positions_(allocate<long long>(n + 1)) {
+		size_t next{};
+		fill(arr, next, 1);
+	}
+
+	/// Возвращает индекс найденного числа key в исходном массиве, либо -1, если число не найдено
+	/// (поиск без ветвлений best - O(log(n)), average - O(log(n)), worst - O(log(n)))
+	long long search(const Arr_type& key) const {
+		const Arr_type* keys = keys_.get();
+		size_t k{ 1 };
+
+		while (k <= n_) {
+			// Загружает узлы на prefetch_levels уровней ниже текущего
+			prefetch_read(keys + k * prefetch_stride);
+			k = 2 * k + (keys[k] < key);
+		}
+
+		// Отменяет последние повороты направо: k - первый узел не меньше key (нижняя граница)
+		k >>= lowest_zero_bit(k);
+
+		if (k == 0 || key < keys[k]) return -1;
+		return positions_[k];
+	}
+
+	/// Размер индексируемого массива
+	size_t size() const {
+		return n_;
+	}
+
+	/// Объём памяти индекса в байтах
+	size_t memory_bytes() const {
+		return (n_ + 1) * (sizeof(Arr_type) + sizeof(long long));
+	}
+
+private:
+	/// Количество элементов в строке кэша: узлы k * prefetch_stride ... лежат в одной строке
+	static constexpr size_t cache_line = 64;
+	static constexpr size_t prefetch_stride = sizeof(Arr_type) < cache_line ? cache_line / sizeof(Arr_type) : 1;
+
+	/// Освобождает выровненную память
+	struct aligned_deleter {
+		template<class T> void operator()(T* p) const {
+			::operator delete[](p, std::align_val_t(cache_line));
+		}
+	};
+
+	template<class T> using aligned_ptr = std::unique_ptr<T[], aligned_deleter>;
+
+	/// Выделяет выровненную по строке кэша память под count элементов
+	template<class T> static aligned_ptr<T> allocate(size_t count) {
+		return aligned_ptr<T>(static_cast<T*>(::operator new[](count * sizeof(T), std::align_val_t(cache_line))));
+	}
+
+	/// Раскладывает отсортированный массив по узлам дерева обходом в симметричном порядке
+	void fill(const Arr_type arr[], size_t& next, size_t k) {
+		// Спуск влево, пока есть узлы, с сохранением пути
+		size_t path[64];
+		size_t depth{};
+
+		while (true) {
+			while (k <= n_) {
+				path[depth++] = k;
+				k = 2 * k;
+			}
+			if (depth == 0) return;
+
+			k = path[--depth];
+			keys_[k] = arr[next];
+			positions_[k] = static_cast<long long>(next);
+			next++;
+			k = 2 * k + 1;
+		}
+	}
+
+	size_t n_;
+	aligned_ptr<Arr_type> keys_;
+	aligned_ptr<long long> positions_;
+};
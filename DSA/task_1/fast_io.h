@@ -0,0 +1,262 @@
+﻿// Дворников Даниил ИВТ-22
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/// Файл, отображённый в память только для чтения
+class mapped_file {
+public:
+	/// Отображает файл file_name; бросает invalid_argument, если файл не открывается
+	explicit mapped_file(const std::string& file_name) {
+#if defined(_WIN32)
+		file_ = CreateFileA(file_name.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file_ == INVALID_HANDLE_VALUE) throw std::invalid_argument("No such file in directory");
+
+		LARGE_INTEGER file_size{};
+		GetFileSizeEx(file_, &file_size);
+		size_ = static_cast<size_t>(file_size.QuadPart);
+		if (size_ == 0) return;
+
+		mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping_ != nullptr) data_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+#else
+		fd_ = open(file_name.c_str(), O_RDONLY);
+		if (fd_ < 0) throw std::invalid_argument("No such file in directory");
+
+		struct stat st {};
+		fstat(fd_, &st);
+		size_ = static_cast<size_t>(st.st_size);
+		if (size_ == 0) return;
+
+		void* p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd_, 0);
+		if (p != MAP_FAILED) {
+			data_ = static_cast<const char*>(p);
+			madvise(p, size_, MADV_SEQUENTIAL);
+		}
+#endif
+		if (data_ == nullptr) {
+			release();
+			throw std::invalid_argument("No such file in directory");
+		}
+	}
+
+	mapped_file(const mapped_file&) = delete;
+	mapped_file& operator=(const mapped_file&) = delete;
+
+	~mapped_file() {
+		release();
+	}
+
+	/// Начало содержимого файла (nullptr для пустого файла)
+	const char* data() const {
+		return data_;
+	}
+
+	/// Размер файла в байтах
+	size_t size() const {
+		return size_;
+	}
+
+private:
+	void release() {
+#if defined(_WIN32)
+		if (data_ != nullptr) UnmapViewOfFile(data_);
+		if (mapping_ != nullptr) CloseHandle(mapping_);
+		if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+		mapping_ = nullptr;
+		file_ = INVALID_HANDLE_VALUE;
+#else
+		if (data_ != nullptr) munmap(const_cast<char*>(data_), size_);
+		if (fd_ >= 0) close(fd_);
+		fd_ = -1;
+#endif
+		data_ = nullptr;
+	}
+
+#if defined(_WIN32)
+	HANDLE file_{ INVALID_HANDLE_VALUE };
+	HANDLE mapping_{ nullptr };
+#else
+	int fd_{ -1 };
+#endif
+	const char* data_{};
+	size_t size_{};
+};
+
+/// Типы, которые поток читает и пишет как числа и для которых есть from_chars / to_chars
+/// (символьные типы поток выводит буквами, поэтому они идут через поток)
+template<class T> constexpr bool is_text_number_v = std::is_same_v<T, float> || std::is_same_v<T, double>
+	|| (std::is_integral_v<T> && sizeof(T) > 1 && !std::is_same_v<T, bool> && !std::is_same_v<T, wchar_t>
+		&& !std::is_same_v<T, char16_t> && !std::is_same_v<T, char32_t>);
+
+/// Пробельный символ в смысле потокового ввода
+inline bool is_space_char(char c) {
+	return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f';
+}
+
+/// Вызывает body(part) для part из [0, parts): первая часть выполняется в вызывающем потоке
+template<class Body> void run_parts(size_t parts, Body body) {
+	std::vector<std::thread> pool;
+	for (size_t p{ 1 }; p < parts; p++) {
+		pool.emplace_back(body, p);
+	}
+	if (parts > 0) body(0);
+
+	for (auto& th : pool) {
+		th.join();
+	}
+}
+
+/// Число потоков для обработки count элементов: части меньше min_part не окупают запуск потока
+inline size_t io_threads(size_t count, size_t threads) {
+	const size_t min_part = 1 << 16;
+
+	if (threads == 0) threads = std::thread::hardware_concurrency();
+	return std::max<size_t>(1, std::min(threads, count / min_part));
+}
+
+/// Считает числа (последовательности непробельных символов) в [first, last)
+inline size_t count_tokens(const char* first, const char* last) {
+	size_t count{};
+	bool in_token{};
+
+	for (; first != last; first++) {
+		bool space = is_space_char(*first);
+		count += (!space && !in_token);
+		in_token = !space;
+	}
+
+	return count;
+}
+
+/// Разбирает не более limit чисел из [first, last) в out; возвращает false при ошибке формата
+template<class Arr_type> bool parse_tokens(const char* first, const char* last, Arr_type* out, size_t limit) {
+	for (size_t i{}; i < limit; i++) {
+		while (first != last && is_space_char(*first)) first++;
+
+		auto [ptr, ec] = std::from_chars(first, last, out[i]);
+		if (ec != std::errc() || (ptr != last && !is_space_char(*ptr))) return false;
+		first = ptr;
+	}
+
+	return true;
+}
+
+/// Читает из файла file_name в формате "n, затем значения" новый массив и его размер n.
+/// Файл отображается в память, делится на части по пробелам, и части разбираются параллельно
+/// через from_chars: сначала подсчитываются числа каждой части, затем каждая часть пишется со своего смещения
+template<class Arr_type> Arr_type* fast_read_arr(const std::string& file_name, size_t& n, size_t threads = 0) {
+	mapped_file file(file_name);
+	const char* p = file.data();
+	const char* end = p + file.size();
+
+	while (p != end && is_space_char(*p)) p++;
+	auto [ptr, ec] = std::from_chars(p, end, n);
+	if (ec != std::errc() || (ptr != end && !is_space_char(*ptr))) throw std::invalid_argument("Invalid file format");
+	p = ptr;
+
+	const size_t parts = io_threads(n, threads);
+
+	// Границы частей сдвигаются к ближайшему пробелу, чтобы не разрезать число
+	std::vector<const char*> bounds{ p };
+	for (size_t t{ 1 }; t < parts; t++) {
+		const char* b = std::max(bounds.back(), p + (end - p) * t / parts);
+		while (b != end && !is_space_char(*b)) b++;
+		bounds.push_back(b);
+	}
+	bounds.push_back(end);
+
+	std::vector<size_t> offsets(parts + 1);
+	run_parts(parts, [&](size_t t) { offsets[t + 1] = count_tokens(bounds[t], bounds[t + 1]); });
+	for (size_t t{}; t < parts; t++) {
+		offsets[t + 1] += offsets[t];
+	}
+	if (offsets[parts] < n) throw std::invalid_argument("Invalid file format");
+
+	Arr_type* arr = new Arr_type[n];
+	std::atomic<bool> valid{ true };
+
+	// Числа после n-го игнорируются, как при чтении потоком
+	run_parts(parts, [&](size_t t) {
+		if (offsets[t] >= n) return;
+		size_t limit = std::min(offsets[t + 1], n) - offsets[t];
+		if (!parse_tokens(bounds[t], bounds[t + 1], arr + offsets[t], limit)) valid = false;
+	});
+
+	if (!valid) {
+		delete[] arr;
+		throw std::invalid_argument("Invalid file format");
+	}
+
+	return arr;
+}
+
+/// Записывает массив arr размера n в файл file_name в формате "n, затем значения через пробел",
+/// совпадающем побайтно с выводом потока (числа с плавающей точкой - 6 значащих цифр, как у ostream).
+/// Части массива переводятся в текст параллельно через to_chars в буферы потоков, которые пишутся по порядку
+template<class Arr_type> void fast_save_arr(const Arr_type arr[], const std::string& file_name, size_t n, size_t threads = 0) {
+	// Текстовый режим, как у потокового вывода, чтобы переводы строк совпадали
+	std::ofstream file_write(file_name);
+	if (!file_write.is_open()) throw std::invalid_argument("Access error - unable to create file");
+
+	file_write << n << '\n';
+
+	// Наибольшая длина числа с пробелом: "-1.23457e-308 " или 20 цифр целого со знаком
+	const size_t max_chars = 32;
+	const size_t block = 1 << 18;
+	const size_t parts = io_threads(n, threads);
+	std::vector<std::vector<char>> buffers(parts, std::vector<char>(block * max_chars));
+	std::vector<size_t> used(parts);
+
+	for (size_t round_start{}; round_start < n; round_start += parts * block) {
+		run_parts(parts, [&](size_t t) {
+			size_t first = std::min(n, round_start + t * block);
+			size_t last = std::min(n, first + block);
+			char* out = buffers[t].data();
+			char* out_end = out + buffers[t].size();
+
+			for (size_t i{ first }; i < last; i++) {
+				std::to_chars_result res;
+				if constexpr (std::is_floating_point_v<Arr_type>)
+					res = std::to_chars(out, out_end, arr[i], std::chars_format::general, 6);
+				else
+					res = std::to_chars(out, out_end, arr[i]);
+				out = res.ptr;
+				*out++ = ' ';
+			}
+			used[t] = out - buffers[t].data();
+		});
+
+		for (size_t t{}; t < parts; t++) {
+			file_write.write(buffers[t].data(), used[t]);
+		}
+	}
+
+	if (!file_write) throw std::invalid_argument("Access error - unable to create file");
+}
@@ -0,0 +1,189 @@
+﻿// Дворников Даниил ИВТ-22
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/// Обученный индекс по отсортированному массиву: позиция ключа приближается кусочно-линейной функцией
+/// с ошибкой не больше epsilon (как в PGM-индексе), а точный ответ ищется в коротком окне вокруг прогноза.
+/// Индекс хранит только отрезки и обращается к исходному массиву, который должен жить дольше индекса.
+template<class Arr_type> class learned_index {
+	static_assert(std::is_arithmetic_v<Arr_type>, "learned_index requires an arithmetic key type");
+
+public:
+	/// Строит индекс по массиву arr размера n, отсортированному по возрастанию; части массива
+	/// приближаются отрезками параллельно в threads потоках (0 - по числу ядер)
+	learned_index(const Arr_type arr[], size_t n, size_t epsilon = 32, size_t threads = 0) : arr_(arr), n_(n), epsilon_(epsilon) {
+		if (n_ == 0) return;
+
+		if (threads == 0) threads = std::thread::hardware_concurrency();
+		// Части меньше min_part не окупают запуск потока
+		threads = std::max<size_t>(1, std::min(threads, n_ / min_part));
+
+		// Границы частей сдвигаются на начало серии одинаковых ключей
+		std::vector<size_t> bounds{ 0 };
+		for (size_t t{ 1 }; t < threads; t++) {
+			size_t b = std::max(bounds.back(), t * n_ / threads);
+			while (b > 0 && b < n_ && arr_[b] == arr_[b - 1]) b++;
+			if (b > bounds.back() && b < n_) bounds.push_back(b);
+		}
+		bounds.push_back(n_);
+
+		std::vector<std::vector<segment>> parts(bounds.size() - 1);
+		std::vector<std::thread> pool;
+		for (size_t p{ 1 }; p < parts.size(); p++) {
+			pool.emplace_back([this, &parts, &bounds, p]() { fit(bounds[p], bounds[p + 1], parts[p]); });
+		}
+		fit(bounds[0], bounds[1], parts[0]);
+
+		for (auto& th : pool) {
+			th.join();
+		}
+
+		for (const auto& part : parts) {
+			segments_.insert(segments_.end(), part.begin(), part.end());
+		}
+		segments_.shrink_to_fit();
+
+		first_keys_.reserve(segments_.size());
+		for (const segment& s : segments_) {
+			first_keys_.push_back(s.key);
+		}
+	}
+
+	/// Возвращает индекс первого элемента, не меньшего key (n, если такого нет)
+	size_t lower_bound(const Arr_type& key) const {
+		return bound(key, [&key](const Arr_type& v) { return v < key; });
+	}
+
+	/// Возвращает индекс первого элемента, большего key (n, если такого нет)
+	size_t upper_bound(const Arr_type& key) const {
+		return bound(key, [&key](const Arr_type& v) { return !(key < v); });
+	}
+
+	/// Возвращает количество элементов массива из отрезка [low, high]
+	size_t count_in_range(const Arr_type& low, const Arr_type& high) const {
+		if (high < low) return 0;
+		return upper_bound(high) - lower_bound(low);
+	}
+
+	/// Размер индексируемого массива
+	size_t size() const {
+		return n_;
+	}
+
+	/// Количество линейных отрезков
+	size_t segment_count() const {
+		return segments_.size();
+	}
+
+	/// Объём памяти индекса в байтах (без самого массива)
+	size_t memory_bytes() const {
+		return sizeof(*this) + segments_.capacity() * sizeof(segment) + first_keys_.capacity() * sizeof(Arr_type);
+	}
+
+	/// Объём памяти индексируемого массива в байтах
+	size_t array_bytes() const {
+		return n_ * sizeof(Arr_type);
+	}
+
+private:
+	/// Отрезок: позиция pos первого вхождения ключа key и наклон прямой для следующих ключей
+	struct segment {
+		Arr_type key;
+		double slope;
+		size_t pos;
+	};
+
+	static constexpr size_t min_part = 1 << 16;
+
+	/// Приближает отрезками точки (ключ, позиция первого вхождения) массива arr[first, last) методом сужающегося конуса:
+	/// прямая проходит через первую точку отрезка, а допустимые наклоны сужаются, пока все точки лежат в пределах epsilon
+	void fit(size_t first, size_t last, std::vector<segment>& out) const {
+		const double eps = static_cast<double>(epsilon_);
+		double x0{}, y0{};
+		double slope_lo{}, slope_hi{};
+
+		auto close = [&]() {
+			double slope = slope_hi == std::numeric_limits<double>::infinity() ? 0.0 : (slope_lo + slope_hi) / 2;
+			out.back().slope = slope;
+		};
+
+		for (size_t i{ first }; i < last; i++) {
+			if (i > first && arr_[i] == arr_[i - 1]) continue;
+
+			const double x = static_cast<double>(arr_[i]);
+			const double y = static_cast<double>(i);
+
+			if (!out.empty() && x > x0) {
+				const double dx = x - x0;
+				const double lo = (y - eps - y0) / dx;
+				const double hi = (y + eps - y0) / dx;
+
+				if (lo <= slope_hi && hi >= slope_lo) {
+					slope_lo = std::max(slope_lo, lo);
+					slope_hi = std::min(slope_hi, hi);
+					continue;
+				}
+				close();
+			}
+
+			// Новый отрезок начинается в точке (x, y)
+			out.push_back({ arr_[i], 0.0, i });
+			x0 = x;
+			y0 = y;
+			slope_lo = 0.0;
+			slope_hi = std::numeric_limits<double>::infinity();
+		}
+
+		if (!out.empty()) close();
+	}
+
+	/// Возвращает первый индекс, для которого before ложно; before истинно на начальном отрезке массива.
+	/// Поиск идёт в окне epsilon вокруг прогноза; если ответ вне окна (ключ отсутствует после
+	/// длинной серии повторов), окно расширяется экспоненциально
+	template<class Before> size_t bound(const Arr_type& key, Before before) const {
+		if (n_ == 0) return 0;
+
+		// Последний отрезок, начинающийся с ключа не больше key
+		size_t s = std::upper_bound(first_keys_.begin(), first_keys_.end(), key) - first_keys_.begin();
+		// key меньше всех элементов массива
+		if (s == 0) return 0;
+		const segment& seg = segments_[s - 1];
+
+		double predicted = static_cast<double>(seg.pos) + seg.slope * (static_cast<double>(key) - static_cast<double>(seg.key));
+		size_t pos = !(predicted > 0) ? 0 : static_cast<size_t>(std::min(predicted, static_cast<double>(n_)));
+		pos = std::max(pos, seg.pos);
+
+		size_t lo = pos > epsilon_ ? pos - epsilon_ : 0;
+		size_t hi = std::min(n_, pos + epsilon_ + 1);
+		return bound_in(lo, hi, before);
+	}
+
+	/// Расширяет окно [lo, hi) до содержащего ответ и ищет в нём бинарным поиском
+	template<class Before> size_t bound_in(size_t lo, size_t hi, Before before) const {
+		size_t step{ std::max<size_t>(epsilon_, 1) };
+		while (lo > 0 && !before(arr_[lo - 1])) {
+			lo = lo > step ? lo - step : 0;
+			step *= 2;
+		}
+		while (hi < n_ && before(arr_[hi])) {
+			hi = std::min(n_, hi + step);
+			step *= 2;
+		}
+
+		return std::partition_point(arr_ + lo, arr_ + hi, before) - arr_;
+	}
+
+	const Arr_type* arr_;
+	size_t n_;
+	size_t epsilon_;
+	std::vector<segment> segments_;
+	std::vector<Arr_type> first_keys_;
+};
@@ -0,0 +1,361 @@
+﻿// Дворников Даниил ИВТ-22
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+/// Размер, ниже которого отрезок сортируется вставками
+const size_t pdq_insertion_threshold = 24;
+/// Размер, начиная с которого опорный элемент выбирается медианой девяти (ninther)
+const size_t pdq_ninther_threshold = 128;
+/// Число перемещений, после которого сортировка вставками почти упорядоченного отрезка прекращается
+const size_t pdq_partial_insertion_limit = 8;
+/// Размер блока при разбиении без ветвлений (смещения хранятся в unsigned char)
+const size_t pdq_block_size = 64;
+
+/// Сортирует массив arr размера n по возрастанию пирамидальной сортировкой (O(n log(n)) в худшем случае)
+template<class Arr_type> void heap_sort(Arr_type arr[], size_t n) {
+	// Просеивает элемент i вниз в куче из size элементов
+	auto sift_down = [arr](size_t i, size_t size) {
+		Arr_type value = std::move(arr[i]);
+
+		while (2 * i + 1 < size) {
+			size_t child = 2 * i + 1;
+			if (child + 1 < size && arr[child] < arr[child + 1]) child++;
+			if (!(value < arr[child])) break;
+
+			arr[i] = std::move(arr[child]);
+			i = child;
+		}
+		arr[i] = std::move(value);
+	};
+
+	for (size_t i{ n / 2 }; i > 0; i--) {
+		sift_down(i - 1, n);
+	}
+	for (size_t size{ n }; size > 1; size--) {
+		std::swap(arr[0], arr[size - 1]);
+		sift_down(0, size - 1);
+	}
+}
+
+/// Сортирует вставками [begin, end)
+template<class Arr_type> void pdq_insertion_sort(Arr_type* begin, Arr_type* end) {
+	if (begin == end) return;
+
+	for (Arr_type* cur{ begin + 1 }; cur != end; cur++) {
+		Arr_type* sift = cur;
+		Arr_type* sift_1 = cur - 1;
+
+		if (*sift < *sift_1) {
+			Arr_type tmp = std::move(*sift);
+			do {
+				*sift-- = std::move(*sift_1);
+			} while (sift != begin && tmp < *--sift_1);
+			*sift = std::move(tmp);
+		}
+	}
+}
+
+/// Сортирует вставками [begin, end), когда слева от begin есть элемент не больше всех элементов отрезка
+/// (проверка границы не нужна)
+template<class Arr_type> void pdq_unguarded_insertion_sort(Arr_type* begin, Arr_type* end) {
+	if (begin == end) return;
+
+	for (Arr_type* cur{ begin + 1 }; cur != end; cur++) {
+		Arr_type* sift = cur;
+		Arr_type* sift_1 = cur - 1;
+
+		if (*sift < *sift_1) {
+			Arr_type tmp = std::move(*sift);
+			do {
+				*sift-- = std::move(*sift_1);
+			} while (tmp < *--sift_1);
+			*sift = std::move(tmp);
+		}
+	}
+}
+
+/// Пытается отсортировать [begin, end) вставками; прекращает и возвращает false, если перемещений
+/// больше pdq_partial_insertion_limit (отрезок не почти упорядочен)
+template<class Arr_type> bool pdq_partial_insertion_sort(Arr_type* begin, Arr_type* end) {
+	if (begin == end) return true;
+
+	size_t moves{};
+	for (Arr_type* cur{ begin + 1 }; cur != end; cur++) {
+		Arr_type* sift = cur;
+		Arr_type* sift_1 = cur - 1;
+
+		if (*sift < *sift_1) {
+			Arr_type tmp = std::move(*sift);
+			do {
+				*sift-- = std::move(*sift_1);
+			} while (sift != begin && tmp < *--sift_1);
+			*sift = std::move(tmp);
+
+			moves += cur - sift;
+			if (moves > pdq_partial_insertion_limit) return false;
+		}
+	}
+
+	return true;
+}
+
+/// Упорядочивает *a, *b, *c по возрастанию
+template<class Arr_type> void pdq_sort3(Arr_type* a, Arr_type* b, Arr_type* c) {
+	if (*b < *a) std::swap(*a, *b);
+	if (*c < *b) std::swap(*b, *c);
+	if (*b < *a) std::swap(*a, *b);
+}
+
+/// Меняет местами num пар элементов first[offsets_l[i]] и last[-offsets_r[i]]. Если пар поровну с обеих сторон,
+/// выполняются обмены, иначе - циклическая перестановка, требующая меньше перемещений
+template<class Arr_type> void pdq_swap_offsets(Arr_type* first, Arr_type* last, const unsigned char* offsets_l, const unsigned char* offsets_r,
+	size_t num, bool use_swaps) {
+	if (use_swaps) {
+		for (size_t i{}; i < num; i++) {
+			std::swap(first[offsets_l[i]], *(last - offsets_r[i]));
+		}
+	}
+	else if (num > 0) {
+		Arr_type* l = first + offsets_l[0];
+		Arr_type* r = last - offsets_r[0];
+		Arr_type tmp = std::move(*l);
+		*l = std::move(*r);
+
+		for (size_t i{ 1 }; i < num; i++) {
+			l = first + offsets_l[i];
+			*r = std::move(*l);
+			r = last - offsets_r[i];
+			*l = std::move(*r);
+		}
+		*r = std::move(tmp);
+	}
+}
+
+/// Разбивает [begin, end) по опорному элементу *begin: слева меньшие, справа не меньшие.
+/// Возвращает позицию опорного элемента и признак того, что отрезок уже был разбит (обменов не было).
+/// Для арифметических типов элементы сравниваются блоками без ветвлений: результаты сравнений
+/// записываются как смещения, а затем найденные пары меняются местами
+template<class Arr_type> std::pair<Arr_type*, bool> pdq_partition_right(Arr_type* begin, Arr_type* end) {
+	Arr_type pivot = std::move(*begin);
+	Arr_type* first = begin;
+	Arr_type* last = end;
+
+	// Слева от медианы есть элемент не меньше опорного, справа - меньше, поэтому границы не проверяются
+	while (*++first < pivot) {}
+	if (first - 1 == begin) {
+		while (first < last && !(*--last < pivot)) {}
+	}
+	else {
+		while (!(*--last < pivot)) {}
+	}
+
+	const bool already_partitioned = first >= last;
+
+	if (!already_partitioned) {
+		if constexpr (std::is_arithmetic_v<Arr_type>) {
+			std::swap(*first, *last);
+			first++;
+
+			alignas(64) unsigned char offsets_l[pdq_block_size];
+			alignas(64) unsigned char offsets_r[pdq_block_size];
+			Arr_type* offsets_l_base = first;
+			Arr_type* offsets_r_base = last;
+			size_t num_l{}, num_r{}, start_l{}, start_r{};
+
+			while (first < last) {
+				// Неразобранная часть делится между левым и правым блоками
+				const size_t num_unknown = last - first;
+				const size_t left_split = num_l == 0 ? (num_r == 0 ? num_unknown / 2 : num_unknown) : 0;
+				const size_t right_split = num_r == 0 ? (num_unknown - left_split) : 0;
+
+				// Смещение записывается всегда, а счётчик увеличивается только для элемента не на своей стороне
+				if (left_split > 0) {
+					const size_t count = std::min(left_split, pdq_block_size);
+					for (size_t i{}; i < count; i++) {
+						offsets_l[num_l] = static_cast<unsigned char>(i);
+						num_l += !(*first < pivot);
+						first++;
+					}
+				}
+				if (right_split > 0) {
+					const size_t count = std::min(right_split, pdq_block_size);
+					for (size_t i{}; i < count;) {
+						offsets_r[num_r] = static_cast<unsigned char>(++i);
+						num_r += *--last < pivot;
+					}
+				}
+
+				const size_t num = std::min(num_l, num_r);
+				pdq_swap_offsets(offsets_l_base, offsets_r_base, offsets_l + start_l, offsets_r + start_r, num, num_l == num_r);
+				num_l -= num;
+				num_r -= num;
+				start_l += num;
+				start_r += num;
+
+				if (num_l == 0) {
+					start_l = 0;
+					offsets_l_base = first;
+				}
+				if (num_r == 0) {
+					start_r = 0;
+					offsets_r_base = last;
+				}
+			}
+
+			// Оставшиеся элементы одной из сторон переносятся к границе разбиения
+			if (num_l > 0) {
+				while (num_l--) {
+					std::swap(offsets_l_base[offsets_l[start_l + num_l]], *--last);
+				}
+				first = last;
+			}
+			if (num_r > 0) {
+				while (num_r--) {
+					std::swap(*(offsets_r_base - offsets_r[start_r + num_r]), *first);
+					first++;
+				}
+				last = first;
+			}
+		}
+		else {
+			while (first < last) {
+				std::swap(*first, *last);
+				while (*++first < pivot) {}
+				while (!(*--last < pivot)) {}
+			}
+		}
+	}
+
+	Arr_type* pivot_pos = first - 1;
+	*begin = std::move(*pivot_pos);
+	*pivot_pos = std::move(pivot);
+
+	return { pivot_pos, already_partitioned };
+}
+
+/// Разбивает [begin, end) по опорному элементу *begin: слева не большие, справа большие.
+/// Используется, когда опорный элемент равен элементу перед отрезком: все равные ему элементы
+/// уходят влево и больше не сортируются, поэтому массивы с повторами сортируются за линейное время
+template<class Arr_type> Arr_type* pdq_partition_left(Arr_type* begin, Arr_type* end) {
+	Arr_type pivot = std::move(*begin);
+	Arr_type* first = begin;
+	Arr_type* last = end;
+
+	while (pivot < *--last) {}
+	if (last + 1 == end) {
+		while (first < last && !(pivot < *++first)) {}
+	}
+	else {
+		while (!(pivot < *++first)) {}
+	}
+
+	while (first < last) {
+		std::swap(*first, *last);
+		while (pivot < *--last) {}
+		while (!(pivot < *++first)) {}
+	}
+
+	Arr_type* pivot_pos = last;
+	*begin = std::move(*pivot_pos);
+	*pivot_pos = std::move(pivot);
+
+	return pivot_pos;
+}
+
+/// Основной цикл сортировки [begin, end): bad_allowed - число допустимых сильно несбалансированных разбиений
+/// до перехода на пирамидальную сортировку, leftmost - отрезок начинается с начала массива
+template<class Arr_type> void pdq_sort_loop(Arr_type* begin, Arr_type* end, int bad_allowed, bool leftmost) {
+	while (true) {
+		const size_t size = end - begin;
+
+		if (size < pdq_insertion_threshold) {
+			if (leftmost) pdq_insertion_sort(begin, end);
+			else pdq_unguarded_insertion_sort(begin, end);
+			return;
+		}
+
+		// Опорный элемент - медиана трёх или медиана девяти, переносится в начало отрезка
+		const size_t s2 = size / 2;
+		if (size > pdq_ninther_threshold) {
+			pdq_sort3(begin, begin + s2, end - 1);
+			pdq_sort3(begin + 1, begin + (s2 - 1), end - 2);
+			pdq_sort3(begin + 2, begin + (s2 + 1), end - 3);
+			pdq_sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1));
+			std::swap(*begin, *(begin + s2));
+		}
+		else {
+			pdq_sort3(begin + s2, begin, end - 1);
+		}
+
+		// Опорный элемент равен элементу перед отрезком: он не меньше всех элементов отрезка
+		if (!leftmost && !(*(begin - 1) < *begin)) {
+			begin = pdq_partition_left(begin, end) + 1;
+			continue;
+		}
+
+		auto [pivot_pos, already_partitioned] = pdq_partition_right(begin, end);
+
+		const size_t l_size = pivot_pos - begin;
+		const size_t r_size = end - (pivot_pos + 1);
+
+		if (l_size < size / 8 || r_size < size / 8) {
+			// Слишком много плохих разбиений - худший случай быстрой сортировки, переход на пирамидальную
+			if (--bad_allowed == 0) {
+				heap_sort(begin, size);
+				return;
+			}
+
+			// Перемешивание частей разрушает закономерность входных данных, давшую плохое разбиение
+			if (l_size >= pdq_insertion_threshold) {
+				std::swap(*begin, *(begin + l_size / 4));
+				std::swap(*(pivot_pos - 1), *(pivot_pos - l_size / 4));
+
+				if (l_size > pdq_ninther_threshold) {
+					std::swap(*(begin + 1), *(begin + (l_size / 4 + 1)));
+					std::swap(*(begin + 2), *(begin + (l_size / 4 + 2)));
+					std::swap(*(pivot_pos - 2), *(pivot_pos - (l_size / 4 + 1)));
+					std::swap(*(pivot_pos - 3), *(pivot_pos - (l_size / 4 + 2)));
+				}
+			}
+			if (r_size >= pdq_insertion_threshold) {
+				std::swap(*(pivot_pos + 1), *(pivot_pos + (1 + r_size / 4)));
+				std::swap(*(end - 1), *(end - r_size / 4));
+
+				if (r_size > pdq_ninther_threshold) {
+					std::swap(*(pivot_pos + 2), *(pivot_pos + (2 + r_size / 4)));
+					std::swap(*(pivot_pos + 3), *(pivot_pos + (3 + r_size / 4)));
+					std::swap(*(end - 2), *(end - (1 + r_size / 4)));
+					std::swap(*(end - 3), *(end - (2 + r_size / 4)));
+				}
+			}
+		}
+		else if (already_partitioned && pdq_partial_insertion_sort(begin, pivot_pos) && pdq_partial_insertion_sort(pivot_pos + 1, end)) {
+			// Отрезок уже был почти отсортирован
+			return;
+		}
+
+		// Левая часть сортируется рекурсивно, правая - в следующей итерации цикла
+		pdq_sort_loop(begin, pivot_pos, bad_allowed, leftmost);
+		begin = pivot_pos + 1;
+		leftmost = false;
+	}
+}
+
+/// Сортирует массив arr размера n по возрастанию (интроспективная сортировка с защитой от плохих входных данных, pdqsort:
+/// best - O(n) для упорядоченных и состоящих из повторов массивов, average - O(n log(n)), worst - O(n log(n)))
+template<class Arr_type> void pdq_sort(Arr_type arr[], size_t n) {
+	if (n < 2) return;
+
+	// Допустимое число плохих разбиений - log2(n)
+	int bad_allowed{};
+	for (size_t m{ n }; m > 0; m >>= 1) {
+		bad_allowed++;
+	}
+
+	pdq_sort_loop(arr, arr + n, bad_allowed, true);
+}
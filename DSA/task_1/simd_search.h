@@ -0,0 +1,171 @@
+﻿// Дворников Даниил ИВТ-22
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/// Находит в маске совпадений mask номер младшего установленного бита
+inline unsigned lowest_set_bit(uint32_t mask) {
+#if defined(_MSC_VER)
+	unsigned long pos;
+	_BitScanForward(&pos, mask);
+	return pos;
+#else
+	return __builtin_ctz(mask);
+#endif
+}
+
+/// Последовательно ищет key в arr[first, last); возвращает индекс или -1
+template<class Arr_type> long long scalar_search_range(const Arr_type arr[], const Arr_type& key, size_t first, size_t last) {
+	for (size_t i{ first }; i < last; i++) {
+		if (arr[i] == key) return i;
+	}
+
+	return -1;
+}
+
+/// Векторно ищет key в arr[first, last): 4 регистра сравниваются за итерацию,
+/// маски совпадений объединяются, и только при совпадении ищется его позиция.
+/// Для типов без векторной версии используется последовательный поиск.
+template<class Arr_type> long long simd_search_range(const Arr_type arr[], const Arr_type& key, size_t first, size_t last) {
+	size_t i{ first };
+
+#if defined(__AVX2__)
+	// Сравнение 8 элементов int / float или 4 элементов double / long long за одну команду
+	if constexpr ((std::is_integral_v<Arr_type> && sizeof(Arr_type) == 4) || std::is_same_v<Arr_type, float>
+		|| (std::is_integral_v<Arr_type> && sizeof(Arr_type) == 8) || std::is_same_v<Arr_type, double>) {
+		constexpr size_t lanes = 32 / sizeof(Arr_type);
+
+		// Сравнивает регистр с ключом и возвращает маску совпадений по байтам
+		auto match = [](const Arr_type* p, const auto& k) -> uint32_t {
+			if constexpr (std::is_same_v<Arr_type, float>)
+				return _mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(p), k, _CMP_EQ_OQ));
+			else if constexpr (std::is_same_v<Arr_type, double>)
+				return _mm256_movemask_pd(_mm256_cmp_pd(_mm256_loadu_pd(p), k, _CMP_EQ_OQ));
+			else if constexpr (sizeof(Arr_type) == 4)
+				return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), k)));
+			else
+				return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), k)));
+		};
+
+		auto broadcast = [&key]() {
+			if constexpr (std::is_same_v<Arr_type, float>) return _mm256_set1_ps(key);
+			else if constexpr (std::is_same_v<Arr_type, double>) return _mm256_set1_pd(key);
+			else if constexpr (sizeof(Arr_type) == 4) return _mm256_set1_epi32(static_cast<int32_t>(key));
+			else return _mm256_set1_epi64x(static_cast<long long>(key));
+		};
+		const auto k = broadcast();
+
+		for (; i + 4 * lanes <= last; i += 4 * lanes) {
+			uint32_t m0 = match(arr + i, k), m1 = match(arr + i + lanes, k);
+			uint32_t m2 = match(arr + i + 2 * lanes, k), m3 = match(arr + i + 3 * lanes, k);
+			if ((m0 | m1 | m2 | m3) != 0) {
+				// Маски собираются в одну: бит j соответствует элементу i + j
+				uint32_t all = m0 | (m1 << lanes) | (m2 << 2 * lanes) | (m3 << 3 * lanes);
+				return i + lowest_set_bit(all);
+			}
+		}
+		for (; i + lanes <= last; i += lanes) {
+			uint32_t m = match(arr + i, k);
+			if (m != 0) return i + lowest_set_bit(m);
+		}
+	}
+#elif defined(__SSE2__) || defined(_M_X64)
+	// Запасная версия SSE2: 4 элемента int / float или 2 элемента double за одну команду
+	if constexpr ((std::is_integral_v<Arr_type> && sizeof(Arr_type) == 4) || std::is_same_v<Arr_type, float> || std::is_same_v<Arr_type, double>) {
+		constexpr size_t lanes = 16 / sizeof(Arr_type);
+
+		auto match = [](const Arr_type* p, const auto& k) -> uint32_t {
+			if constexpr (std::is_same_v<Arr_type, float>)
+				return _mm_movemask_ps(_mm_cmpeq_ps(_mm_loadu_ps(p), k));
+			else if constexpr (std::is_same_v<Arr_type, double>)
+				return _mm_movemask_pd(_mm_cmpeq_pd(_mm_loadu_pd(p), k));
+			else
+				return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), k)));
+		};
+
+		auto broadcast = [&key]() {
+			if constexpr (std::is_same_v<Arr_type, float>) return _mm_set1_ps(key);
+			else if constexpr (std::is_same_v<Arr_type, double>) return _mm_set1_pd(key);
+			else return _mm_set1_epi32(static_cast<int32_t>(key));
+		};
+		const auto k = broadcast();
+
+		for (; i + 4 * lanes <= last; i += 4 * lanes) {
+			uint32_t m0 = match(arr + i, k), m1 = match(arr + i + lanes, k);
+			uint32_t m2 = match(arr + i + 2 * lanes, k), m3 = match(arr + i + 3 * lanes, k);
+			if ((m0 | m1 | m2 | m3) != 0) {
+				uint32_t all = m0 | (m1 << lanes) | (m2 << 2 * lanes) | (m3 << 3 * lanes);
+				return i + lowest_set_bit(all);
+			}
+		}
+	}
+#endif
+
+	// Хвост массива и типы без векторной версии
+	return scalar_search_range(arr, key, i, last);
+}
+
+/// Возвращает индекс первого вхождения key в массиве arr размера n, либо -1, если число не найдено
+/// (векторный последовательный поиск best - O(1), average - O(n), worst - O(n) с меньшей константой)
+template<class Arr_type> long long simd_incremental_search(const Arr_type arr[], Arr_type key, size_t n) {
+	return simd_search_range(arr, key, 0, n);
+}
+
+/// Возвращает индекс первого вхождения key в массиве arr размера n, либо -1, если число не найдено.
+/// Массив делится на непрерывные части по числу потоков; каждый поток просматривает свою часть блоками
+/// и прекращает поиск, как только другой поток нашёл вхождение с меньшим индексом.
+template<class Arr_type> long long parallel_incremental_search(const Arr_type arr[], Arr_type key, size_t n, size_t threads = 0) {
+	// Блок, после которого поток проверяет, не найден ли уже меньший индекс
+	const size_t block = 1 << 14;
+
+	if (threads == 0) threads = std::thread::hardware_concurrency();
+	if (threads <= 1 || n < 16 * block) return simd_incremental_search(arr, key, n);
+
+	// Наименьший найденный индекс; n - вхождение не найдено
+	std::atomic<size_t> best{ n };
+	size_t chunk = (n + threads - 1) / threads;
+
+	auto worker = [&](size_t first, size_t last) {
+		for (size_t start{ first }; start < last; start += block) {
+			// Вхождение левее текущего блока уже найдено
+			if (best.load(std::memory_order_relaxed) <= start) return;
+
+			long long found = simd_search_range(arr, key, start, std::min(start + block, last));
+			if (found >= 0) {
+				size_t pos = static_cast<size_t>(found);
+				size_t current = best.load();
+				while (pos < current && !best.compare_exchange_weak(current, pos)) {}
+				return;
+			}
+		}
+	};
+
+	std::vector<std::thread> pool;
+	for (size_t t{ 1 }; t < threads && t * chunk < n; t++) {
+		pool.emplace_back(worker, t * chunk, std::min((t + 1) * chunk, n));
+	}
+	// Первая часть, где вхождение вероятнее всего важнее, просматривается вызывающим потоком
+	worker(0, std::min(chunk, n));
+
+	for (auto& th : pool) {
+		th.join();
+	}
+
+	size_t result = best.load();
+	return result == n ? -1 : static_cast<long long>(result);
+}
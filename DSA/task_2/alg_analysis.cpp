@@ -17,19 +17,98 @@
 
 #include <iostream>
 #include "alg_analysis_func.h"
+#include "file_scan.h"
+#include "stats_engine.h"
+#include "tail_count.h"
+#include "multi_pattern.h"
 
 
-int main()
+int main(int argc, char* argv[])
 {
-    string data{""};
+    test();
+
+    // Запуск с аргументом bench выполняет замер скорости подсчёта
+    if (argc > 1 && string(argv[1]) == "bench") {
+        bench_count_capital();
+        bench_count_patterns();
+        return 0;
+    }
+
+    // Запуск с -i файл досчитывает дописанные байты с контрольной точки, с -f файл следит за ростом файла
+    if (argc == 3 && (string(argv[1]) == "-i" || string(argv[1]) == "-f")) {
+        const string file_name{ argv[2] };
+        const string checkpoint_file{ file_name + ".checkpoint" };
+
+        try {
+            if (string(argv[1]) == "-i") {
+                std::cout << file_name << "\t" << count_capital_incremental(file_name, checkpoint_file) << "\n";
+            }
+            else {
+                follow_capital_count(file_name, checkpoint_file, [&](size_t count) {
+                    std::cout << file_name << "\t" << count << std::endl;
+                    return true;
+                });
+            }
+        }
+        catch (invalid_argument& err) {
+            std::cout << err.what();
+            return 1;
+        }
+        return 0;
+    }
+
+    // Запуск с путями к файлам и каталогам: alg_analysis [-t потоки] [-c размер части, МБ] [-o отчёт]
+    // [-p файл образцов] [-m отчёт по образцам] пути...
+    if (argc > 1) {
+        stats_options options;
+        string report_file{ "report.txt" };
+        string patterns_file;
+        string match_report_file{ "matches.txt" };
+        std::vector<string> paths;
+
+        try {
+            for (int i{ 1 }; i < argc; i++) {
+                const string arg{ argv[i] };
+                if ((arg == "-t" || arg == "-c" || arg == "-o" || arg == "-p" || arg == "-m") && i + 1 >= argc) throw invalid_argument("Missing value for " + arg);
+
+                if (arg == "-t") options.threads = std::stoul(argv[++i]);
+                else if (arg == "-c") options.chunk_size = std::stoul(argv[++i]) << 20;
+                else if (arg == "-o") report_file = argv[++i];
+                else if (arg == "-p") patterns_file = argv[++i];
+                else if (arg == "-m") match_report_file = argv[++i];
+                else paths.push_back(arg);
+            }
+
+            const std::vector<string> files = collect_files(paths);
+            const std::vector<file_char_stats> stats = scan_files(files, options);
+            write_stats_report(stats, report_file);
+
+            const char_stats total = total_stats(stats);
+            std::cout << "files\t" << stats.size() << "\nupper\t" << total.upper << "\nlower\t" << total.lower
+                << "\nreport\t" << report_file << "\n";
+
+            // Все образцы считаются одним проходом по частям файлов
+            if (!patterns_file.empty()) {
+                const std::vector<string> patterns = read_patterns(patterns_file);
+                const pattern_matcher matcher(patterns);
+                write_pattern_report(patterns, count_patterns_files(matcher, files, options), match_report_file);
+                std::cout << "patterns\t" << patterns.size() << "\nmatches\t" << match_report_file << "\n";
+            }
+        }
+        catch (std::exception& err) {
+            std::cout << err.what();
+            return 1;
+        }
+        return 0;
+    }
+
     string file_name{ "1.txt" };
 
+    // Файл читается блоками, поэтому его размер не ограничен памятью
     try {
-        data = file_read(data, file_name);
+        std::cout << file_name << "\t" << count_capital_file(file_name);
     }
     catch (invalid_argument& err) {
         std::cout << err.what();
     }
-
-    std::cout << data << "\t" << count_capital_let(data);
 }
\ No newline at end of file
@@ -1,30 +1,122 @@
 ﻿// Дворников Даниил
 
 #include "alg_analysis_func.h"
+#include "utf8_upper.h"
+#include "file_scan.h"
+#include "multi_pattern.h"
+#include "../../PC/async_io/lib.h"
 
-/// Считает количество прописных букв в строке data
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+
+/// Считает количество прописных букв (латиница, греческий, кириллица) в строке data в кодировке UTF-8
 size_t count_capital_let( string& data) {
-	size_t count{};
+	return count_upper_utf8(data.data(), data.size());
+}
+
+/// Читает все символы файла file_name (вместе с переводами строк) в строку data.
+/// Для больших файлов - count_capital_file, которому не нужен весь файл в памяти
+string file_read(string &data, string& file_name) {
+	// Блоки читаются асинхронно (io_uring в Linux) и дописываются в строку по порядку
+	const int64_t size = fileSize(file_name);
+	if (size > 0) data.reserve(data.size() + static_cast<size_t>(size));
+
+	const bool ok = readFileAsync(file_name, [&](uint64_t, const char* block, size_t size) {
+		data.append(block, size);
+	});
+	if (!ok) throw invalid_argument("No such file in directory");
 
-	for (char& i: data) {
-		if ( isupper(i)) count++;
+	return data;
+}
+
+/// Сравнивает скорость эталонного и векторного подсчёта прописных букв на тексте из латиницы и кириллицы
+void bench_count_capital() {
+	using namespace std::chrono;
+
+	const string sample = "Съешь же ещё этих мягких ФРАНЦУЗСКИХ булок, да выпей чаю. The Quick Brown Fox Jumps. ";
+	string text;
+	while (text.size() < (256u << 20)) {
+		text += sample;
 	}
 
-	return count;
+	const auto start_time{ steady_clock::now() };
+	size_t scalar_count = count_upper_scalar(text.data(), text.size());
+	const auto middle_time{ steady_clock::now() };
+	size_t simd_count = count_capital_let(text);
+	const auto end_time{ steady_clock::now() };
+
+	const double gb = text.size() / 1e9;
+	std::cout << "bytes\tscalar GB/s\tcount_capital_let GB/s\tequal\n";
+	std::cout << text.size() << "\t" << gb / duration<double>(middle_time - start_time).count() << "\t"
+		<< gb / duration<double>(end_time - middle_time).count() << "\t" << (scalar_count == simd_count) << "\n";
+
+	// Тот же текст из файла: чтение целиком, потоковое чтение блоками и отображение в память
+	string file_name = "bench_capital.txt";
+	{
+		std::ofstream file_write(file_name, std::ios::binary);
+		file_write.write(text.data(), text.size());
+	}
+	text.clear();
+	text.shrink_to_fit();
+
+	auto time_file = [&](auto count_file) {
+		const auto start{ steady_clock::now() };
+		size_t count = count_file();
+		return std::make_pair(gb / duration<double>(steady_clock::now() - start).count(), count == simd_count);
+	};
+	auto whole = time_file([&]() { string data; file_read(data, file_name); return count_capital_let(data); });
+	auto blocks = time_file([&]() { return count_capital_file(file_name); });
+	auto mapped = time_file([&]() { return count_capital_file_mapped(file_name); });
+	auto async = time_file([&]() { return count_capital_file_async(file_name); });
+
+	std::cout << "file_read GB/s\tcount_capital_file GB/s\tcount_capital_file_mapped GB/s\tcount_capital_file_async GB/s\tequal\n";
+	std::cout << whole.first << "\t" << blocks.first << "\t" << mapped.first << "\t" << async.first << "\t"
+		<< (whole.second && blocks.second && mapped.second && async.second) << "\n";
+
+	std::remove(file_name.c_str());
 }
 
-/// Читает все символы файла file_name в строку data
-string file_read(string &data, string& file_name) {
-	ifstream file_read(file_name);
+/// Сравнивает подсчёт 200 образцов одним проходом с отдельным поиском каждого образца на тексте из случайных слов
+void bench_count_patterns() {
+	using namespace std::chrono;
 
-	if (file_read.is_open()) { // читает по строкам
-		while (getline(file_read, file_name)) {
-			data += file_name;
-		}
+	std::mt19937 gen(1);
+	auto random_word = [&](size_t length) {
+		string word;
+		for (size_t i{}; i < length; i++) word += static_cast<char>('a' + gen() % 26);
+		return word;
+	};
+
+	std::vector<string> vocabulary;
+	for (size_t i{}; i < 5000; i++) vocabulary.push_back(random_word(3 + gen() % 8));
+	string text;
+	while (text.size() < (64u << 20)) {
+		text += vocabulary[gen() % vocabulary.size()];
+		text += ' ';
 	}
-	else throw invalid_argument("No such file in directory");
 
-	file_read.close();
+	// Половина образцов встречается в тексте, половина - нет
+	std::vector<string> patterns;
+	for (size_t i{}; i < 200; i++) patterns.push_back(i % 2 ? vocabulary[gen() % vocabulary.size()] : random_word(5 + gen() % 6));
 
-	return data;
+	const pattern_matcher matcher(patterns);
+	const auto start_time{ steady_clock::now() };
+	const std::vector<uint64_t> single = matcher.count(text.data(), text.size());
+	const auto single_time{ steady_clock::now() };
+	const std::vector<uint64_t> parallel = matcher.count_parallel(text.data(), text.size());
+	const auto parallel_time{ steady_clock::now() };
+
+	std::vector<uint64_t> separate(patterns.size());
+	for (size_t i{}; i < patterns.size(); i++) {
+		for (size_t pos = text.find(patterns[i]); pos != string::npos; pos = text.find(patterns[i], pos + 1)) separate[i]++;
+	}
+	const auto end_time{ steady_clock::now() };
+
+	const double gb = text.size() / 1e9;
+	std::cout << "patterns\tsingle pass GB/s\tparallel GB/s\tfind per pattern GB/s\tequal\n";
+	std::cout << patterns.size() << "\t" << gb / duration<double>(single_time - start_time).count() << "\t"
+		<< gb / duration<double>(parallel_time - single_time).count() << "\t"
+		<< gb / duration<double>(end_time - parallel_time).count() << "\t" << (single == separate && parallel == separate) << "\n";
 }
\ No newline at end of file
@@ -12,8 +12,17 @@ using std::ifstream;
 using std::invalid_argument;
 using std::getline;
 
-/// Считает количество прописных букв в строке data
+/// Считает количество прописных букв (латиница, греческий, кириллица) в строке data в кодировке UTF-8
 size_t count_capital_let( string& data);
 
-/// Читает все символы файла file_name в строку data
-string file_read(string& data, string& file_name);
\ No newline at end of file
+/// Читает все символы файла file_name (вместе с переводами строк) в строку data
+string file_read(string& data, string& file_name);
+
+/// Тестирует функции
+void test();
+
+/// Сравнивает скорость эталонного и векторного подсчёта прописных букв
+void bench_count_capital();
+
+/// Сравнивает подсчёт набора образцов одним проходом (pattern_matcher) с отдельным поиском каждого образца
+void bench_count_patterns();
\ No newline at end of file
@@ -0,0 +1,374 @@
+﻿// Дворников Даниил
+
+#include "alg_analysis_func.h"
+#include "utf8_upper.h"
+#include "file_scan.h"
+#include "stats_engine.h"
+#include "tail_count.h"
+#include "multi_pattern.h"
+
+#include <cassert>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+/// Проверяет, что векторный и потоковый подсчёт прописных букв в text совпадают с эталонным count_upper_scalar
+static void check_upper_count(const string& text) {
+	const size_t expected = count_upper_scalar(text.data(), text.size());
+	assert(count_upper_utf8(text.data(), text.size()) == expected);
+
+	// Потоковый подсчёт при любом разбиении на блоки, в том числе внутри многобайтовых символов
+	for (size_t block : { size_t{ 1 }, size_t{ 2 }, size_t{ 3 }, size_t{ 5 }, size_t{ 31 }, size_t{ 32 }, size_t{ 33 }, text.size() + 1 }) {
+		utf8_upper_counter counter;
+		for (size_t i{}; i < text.size(); i += block) {
+			counter.feed(text.data() + i, std::min(block, text.size() - i));
+		}
+		assert(counter.finish() == expected);
+	}
+}
+
+/// Тестирует подсчёт прописных букв в UTF-8
+static void test_utf8_upper() {
+	/// тест известных значений: ASCII, кириллица, греческий, Latin-1 (знак умножения - не буква)
+	const string ascii{ "Hello World, ABC xyz" };
+	const string cyrillic{ "Привет МИР, ёЁ" };
+	const string greek{ "ΑΒΓ αβγ Ω" };
+	const string latin1{ "ÀÉ× ßÞ" };
+	assert(count_upper_scalar(ascii.data(), ascii.size()) == 5);
+	assert(count_upper_scalar(cyrillic.data(), cyrillic.size()) == 5);
+	assert(count_upper_scalar(greek.data(), greek.size()) == 4);
+	assert(count_upper_scalar(latin1.data(), latin1.size()) == 3);
+	for (const string& text : { ascii, cyrillic, greek, latin1 }) {
+		assert(validate_utf8(text.data(), text.size()));
+		check_upper_count(text);
+	}
+
+	/// тест недопустимых байтов: лишний продолжающий байт, избыточная запись, суррогат, код больше U+10FFFF, обрыв
+	const string invalid{ "A\x80" "B\xC0\x81" "C\xED\xA0\x80" "D\xF4\x90\x80\x80" "E\xFF" "Ж\xD0" };
+	assert(!validate_utf8(invalid.data(), invalid.size()));
+	assert(count_upper_scalar(invalid.data(), invalid.size()) == 6);
+	check_upper_count(invalid);
+
+	/// тест хвостов векторного разбора: 31, 32 и 33 байта с двухбайтовым символом на границе 32 байт
+	for (size_t n : { size_t{ 31 }, size_t{ 32 }, size_t{ 33 } }) {
+		for (size_t pos{}; pos + 2 <= n; pos++) {
+			string text(n, 'a');
+			text.replace(pos, 2, "Ж");
+			text[0] = text[0] == 'a' ? 'Q' : text[0];
+			assert(count_upper_scalar(text.data(), text.size()) == (pos == 0 ? 1u : 2u));
+			check_upper_count(text);
+		}
+	}
+
+	/// тест незавершённого символа на границе блоков
+	{
+		const string text{ "aЖ" };
+		utf8_upper_counter counter;
+		counter.feed(text.data(), 2);
+		assert(counter.pending() == 1 && counter.count() == 0);
+		counter.feed(text.data() + 2, 1);
+		assert(counter.pending() == 0 && counter.count() == 1);
+
+		// Незавершённый в конце текста символ - недопустимые байты
+		counter.feed(text.data() + 1, 1);
+		assert(counter.pending() == 1);
+		assert(counter.finish() == 1);
+	}
+
+	/// тест случайных текстов из букв разных алфавитов и недопустимых байтов
+	{
+		const string pieces[]{ "a", "Z", " ", "ж", "Ж", "ω", "Ω", "é", "É", "€", "😀", "\x80", "\xC3", "\xE2\x82", "\xF0\x9F\x98", "\xED\xB0\x80" };
+		std::mt19937 gen(12345);
+		std::uniform_int_distribution<size_t> piece(0, std::size(pieces) - 1);
+		for (int iter{}; iter < 200; iter++) {
+			string text;
+			const size_t length = gen() % 120;
+			for (size_t i{}; i < length; i++) {
+				text += pieces[piece(gen)];
+			}
+			check_upper_count(text);
+		}
+	}
+}
+
+/// Записывает text в файл file_name без преобразования переводов строк
+static void write_test_file(const string& file_name, const string& text) {
+	std::ofstream file_write(file_name, std::ios::binary);
+	file_write.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+/// Тестирует подсчёт прописных букв в файле блоками и через отображение в память
+static void test_file_scan() {
+	/// тест файла, размер которого не кратен блоку, с многобайтовыми символами на границах блоков
+	const size_t block = 4096;
+	string text;
+	while (text.size() < 3 * block + 123) {
+		text += "Мама мыла РАМУ. Ωμέγα ÀÉ € 😀 Hello! ";
+	}
+	text.resize(3 * block + 123);
+	text.replace(block - 1, 2, "Ж");
+	text.replace(2 * block - 2, 3, "€");
+	text.replace(3 * block - 1, 4, "😀");
+
+	const string file_name{ "test_capital.txt" };
+	write_test_file(file_name, text);
+	const size_t expected = count_upper_scalar(text.data(), text.size());
+	assert(count_capital_file(file_name, block) == expected);
+	assert(count_capital_file(file_name) == expected);
+	assert(count_capital_file_mapped(file_name, block) == expected);
+	assert(count_capital_file_mapped(file_name) == expected);
+	assert(count_capital_file_async(file_name, block) == expected);
+	string data;
+	string name{ file_name };
+	assert(file_read(data, name) == text);
+
+#if defined(__linux__)
+	/// тест файла, размер которого fstat сообщает как 0: /proc читается до конца
+	string proc_name{ "/proc/cpuinfo" };
+	string proc_data;
+	file_read(proc_data, proc_name);
+	assert(!proc_data.empty());
+	assert(count_capital_file_async(proc_name) == count_capital_file(proc_name));
+#endif
+
+	/// тест пустого файла
+	write_test_file(file_name, "");
+	assert(count_capital_file(file_name, block) == 0);
+	assert(count_capital_file_mapped(file_name, block) == 0);
+	std::remove(file_name.c_str());
+}
+
+/// Проверяет, что гистограммы a и b совпадают
+static bool same_stats(const char_stats& a, const char_stats& b) {
+	return a.bytes == b.bytes && a.code_points == b.code_points && a.upper == b.upper && a.lower == b.lower
+		&& a.digits == b.digits && a.whitespace == b.whitespace && a.lines == b.lines && a.invalid == b.invalid
+		&& a.latin == b.latin && a.greek == b.greek && a.cyrillic == b.cyrillic && a.other_script == b.other_script;
+}
+
+/// Тестирует параллельный подсчёт гистограмм по частям файлов и отчёт
+static void test_stats_engine() {
+	/// тест частей: многобайтовые символы и недопустимые байты на границах частей по 4096 байт
+	const size_t chunk = 4096;
+	string text;
+	while (text.size() < 5 * chunk + 77) {
+		text += "Строка 12, ΑΒΓ δ; Latin ÀÉ é\tend\n";
+	}
+	text.resize(5 * chunk + 77);
+	text.replace(chunk - 1, 3, "\xE2\x82" "A");
+	text.replace(2 * chunk - 2, 4, "😀");
+	text.replace(3 * chunk - 2, 4, "\xF0\x9F\x98" "x");
+	text.replace(4 * chunk - 1, 2, "Ж");
+	text.replace(5 * chunk - 1, 2, "\x80\xBF");
+
+	const string file_name{ "test_stats.txt" };
+	write_test_file(file_name, text);
+	char_stats expected;
+	scan_char_stats(reinterpret_cast<const unsigned char*>(text.data()), text.size(), 0, text.size(), expected);
+	assert(expected.invalid > 0 && expected.bytes == text.size());
+
+	const std::vector<file_char_stats> whole = scan_files({ file_name }, { 1, text.size() });
+	const std::vector<file_char_stats> parts = scan_files({ file_name, file_name }, { 4, chunk });
+	assert(whole.size() == 1 && !whole[0].read_error && same_stats(whole[0].stats, expected));
+	assert(parts.size() == 2 && same_stats(parts[0].stats, expected) && same_stats(parts[1].stats, expected));
+	std::remove(file_name.c_str());
+
+	/// тест кавычек CSV: поле с запятой, кавычкой или переводом строки заключается в кавычки
+	std::vector<file_char_stats> files(3);
+	files[0].path = "plain.txt";
+	files[1].path = "a,\"b\".txt";
+	files[2].path = "line\nbreak.txt";
+	files[2].read_error = true;
+	const string report_file{ "test_report.csv" };
+	write_stats_report(files, report_file);
+	std::ifstream report(report_file);
+	std::stringstream content;
+	content << report.rdbuf();
+	report.close();
+	const string csv = content.str();
+	assert(csv.rfind("file,bytes,", 0) == 0);
+	assert(csv.find("\nplain.txt,0,") != string::npos);
+	assert(csv.find("\n\"a,\"\"b\"\".txt\",0,") != string::npos);
+	assert(csv.find("\n\"line\nbreak.txt\",0,") != string::npos);
+	assert(csv.find(",1\nTOTAL,0,") != string::npos);
+	std::remove(report_file.c_str());
+}
+
+/// Дописывает text в конец файла file_name
+static void append_test_file(const string& file_name, const string& text) {
+	std::ofstream file_write(file_name, std::ios::binary | std::ios::app);
+	file_write.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
+
+/// Тестирует инкрементальный подсчёт с контрольной точкой
+static void test_tail_count() {
+	const string file_name{ "test_tail.txt" };
+	const string checkpoint_file{ file_name + ".checkpoint" };
+	std::remove(checkpoint_file.c_str());
+	string text{ "Hello " };
+	write_test_file(file_name, text);
+
+	/// тест дописывания: после первого полного подсчёта читаются только новые байты
+	capital_checkpoint checkpoint;
+	assert(update_capital_checkpoint(file_name, checkpoint));
+	assert(checkpoint.count == 1 && checkpoint.size == text.size());
+	append_test_file(file_name, "World Ж");
+	text += "World Ж";
+	assert(!update_capital_checkpoint(file_name, checkpoint, 3));
+	assert(checkpoint.count == 3 && checkpoint.offset == text.size());
+
+	/// тест символа, разрезанного концом файла: его байты остаются после offset и читаются заново
+	append_test_file(file_name, "\xD0");
+	assert(!update_capital_checkpoint(file_name, checkpoint));
+	assert(checkpoint.count == 3 && checkpoint.offset == text.size() && checkpoint.size == text.size() + 1);
+	append_test_file(file_name, "\x96");
+	text += "Ж";
+	assert(!update_capital_checkpoint(file_name, checkpoint));
+	assert(checkpoint.count == 4 && checkpoint.offset == text.size());
+
+	/// тест усечения: файл пересчитывается целиком
+	text = "ABC";
+	write_test_file(file_name, text);
+	assert(update_capital_checkpoint(file_name, checkpoint));
+	assert(checkpoint.count == 3 && checkpoint.size == 3);
+
+	/// тест перезаписи начала файла на месте: размер не уменьшился, но изменились первые 4 КБ
+	text = string(5000, 'a') + "Q";
+	write_test_file(file_name, text);
+	update_capital_checkpoint(file_name, checkpoint);
+	assert(checkpoint.count == 1);
+	{
+		std::fstream file_rewrite(file_name, std::ios::binary | std::ios::in | std::ios::out);
+		file_rewrite.seekp(100);
+		file_rewrite.write("ZZ", 2);
+	}
+	append_test_file(file_name, "b");
+	assert(update_capital_checkpoint(file_name, checkpoint));
+	assert(checkpoint.count == 3 && checkpoint.size == text.size() + 1);
+
+	/// тест ротации: старый файл переименован, под тем же именем - новый файл, начинающийся так же
+	const string rotated_file{ file_name + ".1" };
+	std::remove(rotated_file.c_str());
+	assert(std::rename(file_name.c_str(), rotated_file.c_str()) == 0);
+	text = string(100, 'a') + "ZZ" + string(4898, 'a') + "QbXY";
+	write_test_file(file_name, text);
+	const bool rotated = update_capital_checkpoint(file_name, checkpoint);
+#if defined(__unix__) || defined(__APPLE__)
+	assert(rotated); // Другой inode
+#endif
+	(void)rotated;
+	assert(checkpoint.count == 5);
+	std::remove(rotated_file.c_str());
+
+	/// тест файла контрольной точки: сохранение поверх существующего, отсутствующий и повреждённый файл
+	save_checkpoint(checkpoint_file, checkpoint);
+	save_checkpoint(checkpoint_file, checkpoint);
+	capital_checkpoint loaded;
+	assert(load_checkpoint(checkpoint_file, loaded));
+	assert(loaded.count == checkpoint.count && loaded.offset == checkpoint.offset && loaded.fingerprint == checkpoint.fingerprint);
+	assert(count_capital_incremental(file_name, checkpoint_file) == 5);
+
+	write_test_file(checkpoint_file, "capital_checkpoint_v1\n1 2 3");
+	assert(!load_checkpoint(checkpoint_file, loaded));
+	write_test_file(checkpoint_file, "capital_checkpoint_v1\n1 2 3 4 5");
+	assert(!load_checkpoint(checkpoint_file, loaded)); // Граница разбора за концом файла
+	write_test_file(checkpoint_file, "garbage\n1 20 3 4 5");
+	assert(!load_checkpoint(checkpoint_file, loaded));
+	assert(count_capital_incremental(file_name, checkpoint_file) == 5);
+
+	std::remove(checkpoint_file.c_str());
+	assert(!load_checkpoint(checkpoint_file, loaded));
+	assert(count_capital_incremental(file_name, checkpoint_file) == 5);
+	assert(load_checkpoint(checkpoint_file, loaded) && loaded.count == 5);
+
+	std::remove(checkpoint_file.c_str());
+	std::remove(file_name.c_str());
+}
+
+/// Считает вхождения каждого образца в text поиском find с шагом в один байт (эталон; пустой образец - 0 вхождений)
+static std::vector<uint64_t> find_counts(const std::vector<string>& patterns, const string& text) {
+	std::vector<uint64_t> counts;
+	for (const string& pattern : patterns) {
+		uint64_t count{};
+		for (size_t pos = text.find(pattern); !pattern.empty() && pos != string::npos; pos = text.find(pattern, pos + 1)) {
+			count++;
+		}
+		counts.push_back(count);
+	}
+	return counts;
+}
+
+/// Тестирует подсчёт набора образцов на совпадениях, пересекающих границы частей и блоков
+static void test_multi_pattern() {
+	// Перекрывающиеся образцы, образец внутри другого, повтор, пустой образец и многобайтовый символ
+	const std::vector<string> patterns{ "abc", "bca", "abcabc", "c", "", "zz", "Жж", "abc", "qqqqqqqqqqqqqqqqqqqqqqqqqqqqqqqq" };
+	const pattern_matcher matcher(patterns);
+	std::mt19937 gen(777);
+
+	// Плотный текст (фильтр по первым байтам почти ничего не пропускает и отключается) и редкий (фильтр работает)
+	string dense, sparse;
+	const string alphabet{ "abcz" };
+	while (dense.size() < 300000) {
+		dense += alphabet[gen() % alphabet.size()];
+		if (gen() % 97 == 0) dense += "Жж";
+	}
+	while (sparse.size() < 300000) {
+		const unsigned r = gen() % 1000;
+		sparse += r == 0 ? string("abcabc") : r == 1 ? string("Жж") : r == 2 ? string(40, 'q') : string(1, 'w');
+	}
+
+	for (const string& text : { dense, sparse }) {
+		const std::vector<uint64_t> expected = find_counts(patterns, text);
+		assert(expected[0] > 0 && expected[4] == 0 && expected[0] == expected[7]);
+
+		/// тест подсчёта целиком и по частям в нескольких потоках
+		assert(matcher.count(text.data(), text.size()) == expected);
+		for (size_t threads : { size_t{ 1 }, size_t{ 2 }, size_t{ 4 } }) {
+			assert(matcher.count_parallel(text.data(), text.size(), threads) == expected);
+		}
+
+		/// тест потокового подсчёта при произвольных размерах блоков
+		for (size_t block : { size_t{ 1 }, size_t{ 2 }, size_t{ 5 }, size_t{ 31 }, size_t{ 4096 } }) {
+			pattern_counter counter(matcher);
+			for (size_t i{}; i < text.size(); i += block) {
+				counter.feed(text.data() + i, std::min(block, text.size() - i));
+			}
+			assert(counter.counts() == expected);
+		}
+		{
+			pattern_counter counter(matcher);
+			for (size_t i{}; i < text.size();) {
+				const size_t block = std::min<size_t>(1 + gen() % 100, text.size() - i);
+				counter.feed(text.data() + i, block);
+				i += block;
+			}
+			assert(counter.counts() == expected);
+		}
+	}
+
+	/// тест файлов по частям наименьшего размера: совпадения на границах частей по 4096 байт
+	string text = sparse.substr(0, 5 * 4096 + 10);
+	text.replace(4096 - 3, 6, "abcabc");
+	text.replace(2 * 4096 - 1, 4, "Жж");
+	text.replace(3 * 4096 - 16, 32, string(32, 'q'));
+	const string file_name{ "test_patterns.txt" };
+	write_test_file(file_name, text);
+	std::vector<uint64_t> expected = find_counts(patterns, text);
+	for (uint64_t& count : expected) count *= 2;
+	std::vector<bool> read_error;
+	assert(count_patterns_files(matcher, { file_name, file_name }, { 3, 4096 }, &read_error) == expected);
+	assert(read_error.size() == 2 && !read_error[0] && !read_error[1]);
+	std::remove(file_name.c_str());
+
+	/// тест автомата без образцов
+	const pattern_matcher empty({ "" });
+	assert(empty.count(text.data(), text.size()) == std::vector<uint64_t>{ 0 });
+}
+
+void test() {
+	test_utf8_upper();
+	test_file_scan();
+	test_stats_engine();
+	test_tail_count();
+	test_multi_pattern();
+}
@@ -0,0 +1,80 @@
+﻿// Дворников Даниил
+
+#include "char_stats.h"
+#include "utf8_upper.h"
+
+#include <vector>
+
+char_stats& char_stats::operator+=(const char_stats& other) {
+	bytes += other.bytes;
+	code_points += other.code_points;
+	upper += other.upper;
+	lower += other.lower;
+	digits += other.digits;
+	whitespace += other.whitespace;
+	lines += other.lines;
+	invalid += other.invalid;
+	latin += other.latin;
+	greek += other.greek;
+	cyrillic += other.cyrillic;
+	other_script += other.other_script;
+	return *this;
+}
+
+void char_stats::add_code_point(uint32_t cp, uint64_t count) {
+	code_points += count;
+	upper += is_upper_code_point(cp) * count;
+	lower += is_lower_code_point(cp) * count;
+	digits += (cp >= '0' && cp <= '9') * count;
+	whitespace += is_space_code_point(cp) * count;
+	lines += (cp == '\n') * count;
+
+	switch (script_of(cp)) {
+	case script::latin: latin += count; break;
+	case script::greek: greek += count; break;
+	case script::cyrillic: cyrillic += count; break;
+	default: other_script += count; break;
+	}
+}
+
+void scan_char_stats(const unsigned char* buf, size_t size, size_t start, size_t stop, char_stats& stats) {
+	// Символ, начатый до start и покрывающий его, принадлежит предыдущей части
+	size_t pos{ start };
+	for (size_t back{ 1 }; back <= 3 && back <= start; back++) {
+		if ((buf[start - back] & 0xC0) == 0x80) continue;
+
+		uint32_t cp{};
+		const size_t len = decode_utf8(buf + start - back, size - (start - back), cp);
+		if (len > back) pos = start - back + len;
+		break;
+	}
+
+	// Символы до U+07FF (ASCII и двухбайтовые) сначала считаются по кодам, а классифицируются один раз в конце
+	std::vector<uint64_t> histogram(0x800);
+
+	while (pos < stop) {
+		const unsigned char b0 = buf[pos];
+		if (b0 < 0x80) {
+			histogram[b0]++;
+			pos++;
+			continue;
+		}
+
+		uint32_t cp{};
+		const size_t len = decode_utf8(buf + pos, size - pos, cp);
+		if (len == 0) {
+			stats.invalid++;
+			pos++;
+		}
+		else {
+			if (cp < 0x800) histogram[cp]++;
+			else stats.add_code_point(cp, 1);
+			pos += len;
+		}
+	}
+
+	for (uint32_t cp{}; cp < 0x800; cp++) {
+		if (histogram[cp] != 0) stats.add_code_point(cp, histogram[cp]);
+	}
+	stats.bytes += stop - start;
+}
@@ -0,0 +1,95 @@
+﻿// Дворников Даниил
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// Проверяет, является ли символ с кодом cp строчной буквой латиницы (ASCII, Latin-1, Latin Extended-A),
+/// греческого алфавита (U+0370 - U+03FF) или кириллицы (U+0400 - U+04FF)
+constexpr bool is_lower_code_point(uint32_t cp) {
+	if (cp < 0x80) return cp >= 'a' && cp <= 'z';
+	if (cp < 0x100) return cp == 0xB5 || (cp >= 0xDF && cp != 0xF7);
+
+	// Latin Extended-A: все символы - буквы, строчные идут в парах после прописных
+	if (cp < 0x180) {
+		if (cp <= 0x137) return cp % 2 == 1;
+		if (cp == 0x138) return true;
+		if (cp <= 0x148) return cp % 2 == 0;
+		if (cp == 0x149) return true;
+		if (cp <= 0x177) return cp % 2 == 1;
+		if (cp == 0x178) return false;
+		return cp == 0x17F || cp % 2 == 0;
+	}
+
+	// Греческий и коптский
+	if (cp >= 0x370 && cp < 0x400) {
+		if (cp < 0x380) return cp == 0x371 || cp == 0x373 || cp == 0x377 || (cp >= 0x37B && cp <= 0x37D);
+		if (cp < 0x3AC) return cp == 0x390;
+		if (cp <= 0x3CE) return true;
+		if (cp < 0x3D8) return cp == 0x3D0 || cp == 0x3D1 || cp >= 0x3D5;
+		if (cp <= 0x3EF) return cp % 2 == 1;
+		return cp <= 0x3F3 || cp == 0x3F5 || cp == 0x3F8 || cp == 0x3FB || cp == 0x3FC;
+	}
+
+	// Кириллица
+	if (cp >= 0x400 && cp < 0x500) {
+		if (cp < 0x430) return false;
+		if (cp < 0x460) return true;
+		if (cp < 0x482) return cp % 2 == 1;
+		if (cp < 0x48A) return false;
+		if (cp < 0x4C0) return cp % 2 == 1;
+		if (cp == 0x4C0) return false;
+		if (cp < 0x4CF) return cp % 2 == 0;
+		if (cp == 0x4CF) return true;
+		return cp % 2 == 1;
+	}
+
+	return false;
+}
+
+/// Проверяет, является ли символ с кодом cp пробельным (ASCII и пробелы Юникода)
+constexpr bool is_space_code_point(uint32_t cp) {
+	return cp == ' ' || (cp >= '\t' && cp <= '\r') || cp == 0x85 || cp == 0xA0 || cp == 0x1680 || (cp >= 0x2000 && cp <= 0x200A)
+		|| cp == 0x2028 || cp == 0x2029 || cp == 0x202F || cp == 0x205F || cp == 0x3000;
+}
+
+/// Письменность символа
+enum class script { latin, greek, cyrillic, other };
+
+/// Возвращает письменность символа с кодом cp (знаки, цифры и пробелы ASCII относятся к other)
+constexpr script script_of(uint32_t cp) {
+	if (cp < 0x80) return ((cp | 0x20) >= 'a' && (cp | 0x20) <= 'z') ? script::latin : script::other;
+	if ((cp >= 0xC0 && cp <= 0x24F && cp != 0xD7 && cp != 0xF7) || (cp >= 0x1E00 && cp <= 0x1EFF)) return script::latin;
+	if ((cp >= 0x370 && cp <= 0x3FF) || (cp >= 0x1F00 && cp <= 0x1FFF)) return script::greek;
+	if (cp >= 0x400 && cp <= 0x52F) return script::cyrillic;
+	return script::other;
+}
+
+/// Гистограмма классов символов текста UTF-8
+struct char_stats {
+	uint64_t bytes{};
+	uint64_t code_points{};
+	uint64_t upper{};
+	uint64_t lower{};
+	uint64_t digits{};
+	uint64_t whitespace{};
+	uint64_t lines{};
+	/// Байты, не образующие допустимых символов UTF-8
+	uint64_t invalid{};
+	uint64_t latin{};
+	uint64_t greek{};
+	uint64_t cyrillic{};
+	uint64_t other_script{};
+
+	char_stats& operator+=(const char_stats& other);
+
+	/// Учитывает count символов с кодом cp
+	void add_code_point(uint32_t cp, uint64_t count);
+};
+
+/// Добавляет в stats символы, первые байты которых лежат в [start, stop) буфера buf размера size.
+/// Символ, начатый до start, пропускается (его учитывает предыдущая часть), а символ, начатый до stop,
+/// дочитывается за stop, поэтому в буфере нужны до 3 байт по обе стороны от части.
+/// Недопустимые байты учитываются по одному, как в count_upper_scalar
+void scan_char_stats(const unsigned char* buf, size_t size, size_t start, size_t stop, char_stats& stats);
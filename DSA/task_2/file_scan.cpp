@@ -0,0 +1,129 @@
+﻿// Дворников Даниил
+
+#include "file_scan.h"
+#include "utf8_upper.h"
+#include "../../PC/async_io/lib.h"
+
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define FILE_SCAN_HAS_MMAP 1
+#endif
+
+namespace {
+
+	/// Выравнивание буфера чтения - размер страницы
+	const size_t block_alignment = 4096;
+
+	/// Освобождает выровненный буфер
+	struct aligned_deleter {
+		void operator()(char* p) const {
+			::operator delete[](p, std::align_val_t(block_alignment));
+		}
+	};
+
+}
+
+size_t count_capital_file(const std::string& file_name, size_t block_size) {
+	block_size = std::max(block_alignment, block_size / block_alignment * block_alignment);
+
+#if defined(FILE_SCAN_HAS_MMAP)
+	// Чтение системным вызовом сразу в буфер без промежуточного буфера потока
+	const int fd = open(file_name.c_str(), O_RDONLY);
+	if (fd < 0) throw std::invalid_argument("No such file in directory");
+#if defined(POSIX_FADV_SEQUENTIAL)
+	posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+#else
+	std::ifstream file(file_name, std::ios::binary);
+	if (!file.is_open()) throw std::invalid_argument("No such file in directory");
+	file.rdbuf()->pubsetbuf(nullptr, 0);
+#endif
+
+	std::unique_ptr<char[], aligned_deleter> buffer(static_cast<char*>(::operator new[](block_size, std::align_val_t(block_alignment))));
+	utf8_upper_counter counter;
+
+	while (true) {
+#if defined(FILE_SCAN_HAS_MMAP)
+		const ssize_t got = read(fd, buffer.get(), block_size);
+		if (got < 0) {
+			close(fd);
+			throw std::invalid_argument("Read error");
+		}
+#else
+		file.read(buffer.get(), static_cast<std::streamsize>(block_size));
+		const std::streamsize got = file.gcount();
+#endif
+		if (got == 0) break;
+		counter.feed(buffer.get(), static_cast<size_t>(got));
+	}
+
+#if defined(FILE_SCAN_HAS_MMAP)
+	close(fd);
+#endif
+	return counter.finish();
+}
+
+size_t count_capital_file_mapped(const std::string& file_name, size_t window_size) {
+#if defined(FILE_SCAN_HAS_MMAP)
+	const int fd = open(file_name.c_str(), O_RDONLY);
+	if (fd < 0) throw std::invalid_argument("No such file in directory");
+
+	struct stat st {};
+	// Размер неизвестен или файл не обычный (канал, устройство): читает потоком
+	if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+		close(fd);
+		return count_capital_file(file_name);
+	}
+	const size_t size = static_cast<size_t>(st.st_size);
+	if (size == 0) {
+		close(fd);
+		return 0;
+	}
+
+	void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (mapped == MAP_FAILED) return count_capital_file(file_name);
+
+	char* data = static_cast<char*>(mapped);
+	madvise(mapped, size, MADV_SEQUENTIAL);
+
+	const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	window_size = std::max(page, window_size / page * page);
+	utf8_upper_counter counter;
+
+	for (size_t offset{}; offset < size; offset += window_size) {
+		const size_t length = std::min(window_size, size - offset);
+		counter.feed(data + offset, length);
+		// Просмотренные страницы больше не нужны: память процесса не растёт с размером файла
+		madvise(data + offset, length, MADV_DONTNEED);
+	}
+
+	munmap(mapped, size);
+	return counter.finish();
+#else
+	return count_capital_file(file_name, window_size);
+#endif
+}
+
+size_t count_capital_file_async(const std::string& file_name, size_t block_size, size_t queue_depth) {
+	AsyncReadOptions options;
+	options.blockSize = block_size;
+	options.queueDepth = queue_depth;
+
+	utf8_upper_counter counter;
+	const bool ok = readFileAsync(file_name, [&](uint64_t, const char* data, size_t size) {
+		counter.feed(data, size);
+	}, options);
+	if (!ok) throw std::invalid_argument("No such file in directory");
+
+	return counter.finish();
+}
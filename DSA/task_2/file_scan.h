@@ -0,0 +1,23 @@
+﻿// Дворников Даниил
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+/// Размер блока чтения по умолчанию
+const size_t default_scan_block = 1 << 20;
+
+/// Считает прописные буквы в файле file_name, читая его выровненными блоками block_size байт
+/// и передавая их сразу в utf8_upper_counter: память не зависит от размера файла.
+/// Бросает invalid_argument, если файл не открывается
+size_t count_capital_file(const std::string& file_name, size_t block_size = default_scan_block);
+
+/// То же, что count_capital_file, но файл отображается в память (mmap с madvise(MADV_SEQUENTIAL)),
+/// а просмотренные окна window_size байт сразу освобождаются. Без mmap (Windows) файл читается блоками
+size_t count_capital_file_mapped(const std::string& file_name, size_t window_size = 64 * default_scan_block);
+
+/// То же, что count_capital_file, но блоки читаются асинхронно (../../PC/async_io/lib.h): в Linux через io_uring
+/// с queue_depth блоками block_size байт в полёте, и каждый готовый блок сразу передаётся в utf8_upper_counter.
+/// Без io_uring файл читается блокирующим pread. Бросает invalid_argument, если файл не открывается или не читается
+size_t count_capital_file_async(const std::string& file_name, size_t block_size = default_scan_block, size_t queue_depth = 8);
@@ -0,0 +1,336 @@
+﻿// Дворников Даниил
+
+#include "multi_pattern.h"
+
+#include <algorithm>
+#include <bit>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+
+	/// Отсутствующий переход в боре и образец, не имеющий состояния (пустой)
+	const uint32_t no_state = std::numeric_limits<uint32_t>::max();
+
+	/// Число групп образцов в фильтре (бит в байте таблицы)
+	const size_t filter_buckets = 8;
+
+	/// Минимальная часть текста на поток в count_parallel
+	const size_t min_parallel_part = 1 << 16;
+
+	/// Число независимых проходов автомата, чередуемых в одном потоке
+	const size_t lanes = 4;
+
+	/// Минимальный текст для чередования проходов
+	const size_t min_interleaved = 1 << 14;
+
+	/// Таблица переходов автомата в виде, удобном для внутренних циклов
+	struct transitions {
+		const uint32_t* next;
+		const uint16_t* byte_class;
+		uint32_t classes;
+		uint32_t output_bit;
+
+		/// Переход из строки row по байту c с учётом посещения состояния с выходом
+		uint32_t step(uint32_t row, unsigned char c, uint64_t* visits) const {
+			const uint32_t target = next[row + byte_class[c]];
+			row = target & ~output_bit;
+			if ((target & output_bit) && visits) visits[row / classes]++;
+			return row;
+		}
+
+		/// Проходит data размера n из строки row
+		uint32_t run(const unsigned char* data, size_t n, uint32_t row, uint64_t* visits) const {
+			for (size_t i{}; i < n; i++) row = step(row, data[i], visits);
+			return row;
+		}
+	};
+
+}
+
+pattern_matcher::pattern_matcher(const std::vector<std::string>& patterns) {
+	// Классы байтов: каждый байт из образцов - свой класс, остальные - класс 0
+	std::array<bool, 256> used{};
+	for (const std::string& pattern : patterns) {
+		for (unsigned char c : pattern) used[c] = true;
+	}
+	classes_ = 1;
+	for (size_t b{}; b < 256; b++) {
+		byte_class_[b] = used[b] ? static_cast<uint16_t>(classes_++) : 0;
+	}
+
+	// Бор образцов
+	std::vector<uint32_t> trie(classes_, no_state);
+	std::vector<bool> output(1);
+	terminal_.assign(patterns.size(), no_state);
+
+	for (size_t i{}; i < patterns.size(); i++) {
+		if (patterns[i].empty()) continue;
+
+		uint32_t state{ root };
+		for (unsigned char c : patterns[i]) {
+			uint32_t& child = trie[state * classes_ + byte_class_[c]];
+			if (child == no_state) {
+				child = static_cast<uint32_t>(output.size());
+				output.push_back(false);
+				trie.resize(trie.size() + classes_, no_state);
+			}
+			state = trie[state * classes_ + byte_class_[c]];
+		}
+		terminal_[i] = state;
+		output[state] = true;
+		max_length_ = std::max(max_length_, patterns[i].size());
+	}
+
+	// Суффиксные ссылки и недостающие переходы обходом в ширину: ссылка ведёт в состояние меньшей глубины,
+	// обработанное раньше, поэтому его переходы и признак выхода уже окончательны
+	fail_.assign(output.size(), root);
+	order_.assign(1, root);
+	for (size_t k{}; k < order_.size(); k++) {
+		const uint32_t state = order_[k];
+		for (size_t c{}; c < classes_; c++) {
+			uint32_t& target = trie[state * classes_ + c];
+			const uint32_t fallback = state == root ? root : trie[fail_[state] * classes_ + c];
+			if (target == no_state) {
+				target = fallback;
+				continue;
+			}
+			fail_[target] = fallback;
+			output[target] = output[target] || output[fallback];
+			order_.push_back(target);
+		}
+	}
+
+	// Переходы хранят смещение строки следующего состояния, чтобы не умножать на каждом байте
+	next_.resize(trie.size());
+	for (size_t i{}; i < trie.size(); i++) {
+		next_[i] = static_cast<uint32_t>(trie[i] * classes_) | (output[trie[i]] ? output_bit : 0);
+	}
+
+	// Группы фильтра: образцы, упорядоченные по началу, делятся на 8 равных частей, чтобы похожие начала
+	// попадали в одну группу. Байты за концом короткого образца могут быть любыми
+	std::vector<std::string> sorted;
+	for (const std::string& pattern : patterns) {
+		if (!pattern.empty()) sorted.push_back(pattern);
+	}
+	std::sort(sorted.begin(), sorted.end());
+	sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+
+	for (size_t i{}; i < sorted.size(); i++) {
+		const uint8_t bucket = static_cast<uint8_t>(1u << (i * filter_buckets / sorted.size()));
+		for (size_t k{}; k < 3; k++) {
+			if (k < sorted[i].size()) {
+				const unsigned char c = static_cast<unsigned char>(sorted[i][k]);
+				filter_lo_[k][c & 15] |= bucket;
+				filter_hi_[k][c >> 4] |= bucket;
+			}
+			else {
+				for (size_t x{}; x < 16; x++) {
+					filter_lo_[k][x] |= bucket;
+					filter_hi_[k][x] |= bucket;
+				}
+			}
+		}
+	}
+
+#if defined(__AVX2__)
+	use_filter_ = !sorted.empty();
+#endif
+}
+
+size_t pattern_matcher::next_candidate(const unsigned char* data, size_t pos, size_t n) const {
+#if defined(__AVX2__)
+	const __m256i low_nibble = _mm256_set1_epi8(0x0F);
+	__m256i lo[3], hi[3];
+	for (size_t k{}; k < 3; k++) {
+		lo[k] = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(filter_lo_[k].data())));
+		hi[k] = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(filter_hi_[k].data())));
+	}
+
+	// Группы, в которых образец может начаться с каждой из 32 позиций: пересечение по 3 первым байтам
+	while (pos + 34 <= n) {
+		__m256i groups = _mm256_set1_epi8(-1);
+		for (size_t k{}; k < 3; k++) {
+			const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos + k));
+			const __m256i l = _mm256_shuffle_epi8(lo[k], _mm256_and_si256(v, low_nibble));
+			const __m256i h = _mm256_shuffle_epi8(hi[k], _mm256_and_si256(_mm256_srli_epi16(v, 4), low_nibble));
+			groups = _mm256_and_si256(groups, _mm256_and_si256(l, h));
+		}
+		const uint32_t empty = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(groups, _mm256_setzero_si256())));
+		if (empty != 0xFFFFFFFFu) return pos + static_cast<size_t>(std::countr_one(empty));
+		pos += 32;
+	}
+#endif
+
+	// Конец текста: недостающие байты считаются подходящими, чтобы начало образца перешло в следующий блок
+	for (; pos < n; pos++) {
+		uint8_t groups{ 0xFF };
+		for (size_t k{}; k < 3 && pos + k < n; k++) {
+			const unsigned char c = data[pos + k];
+			groups &= filter_lo_[k][c & 15] & filter_hi_[k][c >> 4];
+		}
+		if (groups != 0) return pos;
+	}
+	return n;
+}
+
+uint32_t pattern_matcher::run(const unsigned char* data, size_t n, uint32_t state, uint64_t* visits) const {
+	const transitions table{ next_.data(), byte_class_.data(), static_cast<uint32_t>(classes_), output_bit };
+	uint32_t row = static_cast<uint32_t>(state * classes_);
+	size_t pos{};
+
+	// Фильтр вызывается только в корне; если он почти ничего не пропускает, остаток текста идёт без него
+	if (use_filter_) {
+		size_t filter_calls{}, filter_skipped{};
+		while (pos < n) {
+			if (row == root) {
+				const size_t candidate = next_candidate(data, pos, n);
+				filter_skipped += candidate - pos;
+				pos = candidate;
+				if (pos == n) break;
+				if (++filter_calls % 1024 == 0 && filter_skipped < filter_calls * 4) break;
+			}
+			row = table.step(row, data[pos++], visits);
+		}
+	}
+
+	// Без фильтра скорость ограничена задержкой чтения перехода, поэтому текст делится на lanes отрезков,
+	// которые проходятся одновременно: каждый отрезок, кроме первого, начинается с прохода по max_length_ - 1
+	// байтам перед ним без подсчёта, а итоговое состояние - состояние последнего отрезка
+	const size_t overlap = max_length_ > 0 ? max_length_ - 1 : 0;
+	const size_t segment = (n - pos) / lanes;
+	if (n - pos >= min_interleaved && overlap <= segment) {
+		const unsigned char* text = data + pos;
+		uint32_t rows[lanes]{ row };
+		for (size_t k{ 1 }; k < lanes; k++) {
+			rows[k] = table.run(text + k * segment - overlap, overlap, root, nullptr);
+		}
+		for (size_t i{}; i < segment; i++) {
+			for (size_t k{}; k < lanes; k++) rows[k] = table.step(rows[k], text[k * segment + i], visits);
+		}
+		row = rows[lanes - 1];
+		pos += lanes * segment;
+	}
+
+	row = table.run(data + pos, n - pos, row, visits);
+	return static_cast<uint32_t>(row / classes_);
+}
+
+std::vector<uint64_t> pattern_matcher::counts_from_visits(std::vector<uint64_t> visits) const {
+	// Вхождение образца заканчивается в каждом состоянии, из которого суффиксные ссылки ведут в его конечное состояние
+	for (size_t k{ order_.size() }; k-- > 1;) {
+		visits[fail_[order_[k]]] += visits[order_[k]];
+	}
+
+	std::vector<uint64_t> counts(terminal_.size());
+	for (size_t i{}; i < terminal_.size(); i++) {
+		if (terminal_[i] != no_state) counts[i] = visits[terminal_[i]];
+	}
+	return counts;
+}
+
+std::vector<uint64_t> pattern_matcher::count(const char* data, size_t n) const {
+	std::vector<uint64_t> visits(state_count());
+	run(reinterpret_cast<const unsigned char*>(data), n, root, visits.data());
+	return counts_from_visits(std::move(visits));
+}
+
+std::vector<uint64_t> pattern_matcher::count_parallel(const char* data, size_t n, size_t threads) const {
+	if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+	threads = std::max<size_t>(1, std::min(threads, n / min_parallel_part));
+
+	const unsigned char* text = reinterpret_cast<const unsigned char*>(data);
+	const size_t overlap = max_length_ > 0 ? max_length_ - 1 : 0;
+	std::vector<std::vector<uint64_t>> local(threads, std::vector<uint64_t>(state_count()));
+
+	// Часть начинается с прохода по overlap байтам перед ней без подсчёта: так совпадения,
+	// заканчивающиеся в части, учитываются ровно один раз
+	auto worker = [&](size_t t) {
+		const size_t begin = n * t / threads;
+		const size_t end = n * (t + 1) / threads;
+		const size_t from = begin - std::min(begin, overlap);
+		const uint32_t state = run(text + from, begin - from, root, nullptr);
+		run(text + begin, end - begin, state, local[t].data());
+	};
+
+	std::vector<std::thread> pool;
+	for (size_t t{ 1 }; t < threads; t++) pool.emplace_back(worker, t);
+	worker(0);
+	for (std::thread& thread : pool) thread.join();
+
+	for (size_t t{ 1 }; t < threads; t++) {
+		for (size_t s{}; s < local[0].size(); s++) local[0][s] += local[t][s];
+	}
+	return counts_from_visits(std::move(local[0]));
+}
+
+pattern_counter::pattern_counter(const pattern_matcher& matcher) : matcher_(&matcher), visits_(matcher.state_count()) {}
+
+void pattern_counter::feed(const char* data, size_t n) {
+	state_ = matcher_->run(reinterpret_cast<const unsigned char*>(data), n, state_, visits_.data());
+}
+
+std::vector<uint64_t> pattern_counter::counts() const {
+	return matcher_->counts_from_visits(visits_);
+}
+
+std::vector<uint64_t> count_patterns_files(const pattern_matcher& matcher, const std::vector<std::string>& files,
+	const stats_options& options, std::vector<bool>* read_error) {
+	std::vector<std::vector<uint64_t>> local(stats_threads(options));
+	const size_t overlap = matcher.max_length() > 0 ? matcher.max_length() - 1 : 0;
+
+	std::vector<bool> errors = for_each_file_chunk(files, options, overlap, 0, [&](size_t thread, const file_chunk& chunk) {
+		if (local[thread].empty()) local[thread].resize(matcher.state_count());
+		const uint32_t state = matcher.run(chunk.buf, chunk.start, pattern_matcher::root, nullptr);
+		matcher.run(chunk.buf + chunk.start, chunk.stop - chunk.start, state, local[thread].data());
+	});
+	if (read_error) *read_error = std::move(errors);
+
+	std::vector<uint64_t> visits(matcher.state_count());
+	for (const std::vector<uint64_t>& thread_visits : local) {
+		for (size_t s{}; s < thread_visits.size(); s++) visits[s] += thread_visits[s];
+	}
+	return matcher.counts_from_visits(std::move(visits));
+}
+
+std::vector<std::string> read_patterns(const std::string& file_name) {
+	std::ifstream file(file_name, std::ios::binary);
+	if (!file.is_open()) throw std::invalid_argument("No such file in directory");
+
+	std::vector<std::string> patterns;
+	std::string line;
+	while (std::getline(file, line)) {
+		if (!line.empty() && line.back() == '\r') line.pop_back();
+		if (!line.empty()) patterns.push_back(line);
+	}
+	return patterns;
+}
+
+void write_pattern_report(const std::vector<std::string>& patterns, const std::vector<uint64_t>& counts, const std::string& report_file) {
+	std::ofstream out(report_file);
+	if (!out.is_open()) throw std::invalid_argument("Access error - unable to create file");
+
+	const bool csv = report_file.size() >= 4 && report_file.compare(report_file.size() - 4, 4, ".csv") == 0;
+	out << (csv ? "pattern,count\n" : "count\tpattern\n");
+
+	for (size_t i{}; i < patterns.size(); i++) {
+		if (!csv) {
+			out << counts[i] << '\t' << patterns[i] << '\n';
+			continue;
+		}
+
+		// Образец в кавычках, кавычки внутри удваиваются
+		out << '"';
+		for (char c : patterns[i]) {
+			if (c == '"') out << '"';
+			out << c;
+		}
+		out << "\"," << counts[i] << '\n';
+	}
+}
@@ -0,0 +1,107 @@
+﻿// Дворников Даниил
+
+#pragma once
+
+#include "stats_engine.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Подсчёт вхождений набора образцов за один проход по тексту (алгоритм Ахо - Корасик).
+/// Автомат хранится полной таблицей переходов по классам байтов (байты, не встречающиеся в образцах, - один класс).
+/// При каждом байте учитывается только посещение состояния, у которого есть выход, а число вхождений образца
+/// получается в конце суммированием посещений по дереву суффиксных ссылок.
+/// Пока автомат в корне, участки текста, где не может начаться ни один образец, пропускаются фильтром
+/// по первым 3 байтам образцов (8 групп, таблицы по полубайтам, AVX2 - по 32 позиции за шаг)
+class pattern_matcher {
+public:
+	/// Строит автомат по образцам; пустые образцы не встречаются ни разу
+	explicit pattern_matcher(const std::vector<std::string>& patterns);
+
+	size_t pattern_count() const {
+		return terminal_.size();
+	}
+
+	/// Длина самого длинного образца: соседние части текста должны перекрываться на max_length() - 1 байт
+	size_t max_length() const {
+		return max_length_;
+	}
+
+	size_t state_count() const {
+		return fail_.size();
+	}
+
+	/// Начальное состояние автомата
+	static constexpr uint32_t root = 0;
+
+	/// Проходит data размера n из состояния state и возвращает новое состояние.
+	/// Если visits не nullptr, увеличивает visits[s] для каждого посещённого состояния s с выходом
+	uint32_t run(const unsigned char* data, size_t n, uint32_t state, uint64_t* visits) const;
+
+	/// Переводит посещения состояний (размер state_count()) в число вхождений каждого образца
+	std::vector<uint64_t> counts_from_visits(std::vector<uint64_t> visits) const;
+
+	/// Считает вхождения всех образцов в data размера n
+	std::vector<uint64_t> count(const char* data, size_t n) const;
+
+	/// Считает вхождения всех образцов в data размера n параллельно по частям (threads = 0 - по числу ядер)
+	std::vector<uint64_t> count_parallel(const char* data, size_t n, size_t threads = 0) const;
+
+private:
+	/// Бит состояния в таблице переходов: у состояния есть выход
+	static constexpr uint32_t output_bit = 1u << 31;
+
+	/// Возвращает первую позицию из [pos, n), с которой может начаться образец, или n
+	size_t next_candidate(const unsigned char* data, size_t pos, size_t n) const;
+
+	std::array<uint16_t, 256> byte_class_{};
+	size_t classes_{};
+	/// Переходы: next_[состояние * classes_ + класс] = состояние | output_bit
+	std::vector<uint32_t> next_;
+	std::vector<uint32_t> fail_;
+	/// Состояния в порядке обхода в ширину
+	std::vector<uint32_t> order_;
+	/// Состояние, в котором заканчивается каждый образец
+	std::vector<uint32_t> terminal_;
+	size_t max_length_{};
+
+	/// Фильтр: filter_lo_[k][x & 15] & filter_hi_[k][x >> 4] - группы образцов, у которых k-й байт может быть x
+	std::array<std::array<uint8_t, 16>, 3> filter_lo_{};
+	std::array<std::array<uint8_t, 16>, 3> filter_hi_{};
+	bool use_filter_{};
+};
+
+/// Потоковый подсчёт образцов: текст подаётся блоками произвольного размера по порядку,
+/// совпадения на границах блоков учитываются за счёт состояния автомата между блоками
+class pattern_counter {
+public:
+	explicit pattern_counter(const pattern_matcher& matcher);
+
+	/// Добавляет очередной блок data размера n
+	void feed(const char* data, size_t n);
+
+	/// Число вхождений каждого образца в поданном тексте
+	std::vector<uint64_t> counts() const;
+
+private:
+	const pattern_matcher* matcher_;
+	uint32_t state_{ pattern_matcher::root };
+	std::vector<uint64_t> visits_;
+};
+
+/// Считает вхождения образцов во всех файлах files: части файлов разбираются пулом потоков (for_each_file_chunk),
+/// каждая часть читается с max_length() - 1 байтами перед ней, чтобы учесть совпадения на границе.
+/// Каждый поток копит свои посещения состояний, они складываются после завершения потоков.
+/// Если read_error не nullptr, в него записываются признаки ошибок чтения файлов
+std::vector<uint64_t> count_patterns_files(const pattern_matcher& matcher, const std::vector<std::string>& files,
+	const stats_options& options = {}, std::vector<bool>* read_error = nullptr);
+
+/// Читает образцы из файла file_name, по одному в строке (пустые строки пропускаются).
+/// Бросает invalid_argument, если файл не открывается
+std::vector<std::string> read_patterns(const std::string& file_name);
+
+/// Записывает отчёт "образец - число вхождений" в report_file: CSV, если имя оканчивается на .csv, иначе через табуляцию.
+/// Бросает invalid_argument, если файл не создаётся
+void write_pattern_report(const std::vector<std::string>& patterns, const std::vector<uint64_t>& counts, const std::string& report_file);
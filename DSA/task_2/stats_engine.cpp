@@ -0,0 +1,208 @@
+﻿// Дворников Даниил
+
+#include "stats_engine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+	/// Часть файла [begin, end)
+	struct scan_task {
+		size_t file;
+		uint64_t begin;
+		uint64_t end;
+	};
+
+	/// Байты, дочитываемые по обе стороны от части для символов на её границах
+	const size_t utf8_margin = 3;
+
+	/// Читает часть task файла path вместе с before байтами перед ней и after после неё в buffer
+	bool read_chunk(const std::string& path, const scan_task& task, size_t before, size_t after,
+		std::vector<unsigned char>& buffer, file_chunk& chunk) {
+		std::ifstream file(path, std::ios::binary);
+		if (!file.is_open()) return false;
+
+		const uint64_t from = task.begin - std::min<uint64_t>(task.begin, before);
+		buffer.resize(static_cast<size_t>(task.end - from + after));
+		file.seekg(static_cast<std::streamoff>(from));
+		file.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+		if (file.bad()) return false;
+
+		// Файл мог укоротиться после получения размера
+		const size_t got = static_cast<size_t>(file.gcount());
+		chunk = { task.file, buffer.data(), got, static_cast<size_t>(task.begin - from),
+			std::min(static_cast<size_t>(task.end - from), got) };
+		chunk.start = std::min(chunk.start, chunk.stop);
+		return true;
+	}
+
+	/// Записывает значение поля CSV, заключая его в кавычки при необходимости
+	void write_csv_field(std::ofstream& out, const std::string& value) {
+		if (value.find_first_of(",\"\r\n") == std::string::npos) {
+			out << value;
+			return;
+		}
+		out << '"';
+		for (char c : value) {
+			if (c == '"') out << '"';
+			out << c;
+		}
+		out << '"';
+	}
+
+	/// Названия столбцов отчёта
+	const char* const column_names[] = { "bytes", "code_points", "upper", "lower", "digits", "whitespace", "lines",
+		"invalid", "latin", "greek", "cyrillic", "other" };
+
+	/// Значения столбцов отчёта в порядке column_names
+	std::vector<uint64_t> columns(const char_stats& s) {
+		return { s.bytes, s.code_points, s.upper, s.lower, s.digits, s.whitespace, s.lines,
+			s.invalid, s.latin, s.greek, s.cyrillic, s.other_script };
+	}
+
+}
+
+std::vector<std::string> collect_files(const std::vector<std::string>& paths) {
+	std::vector<std::string> files;
+	for (const std::string& path : paths) {
+		std::error_code error;
+		if (fs::is_regular_file(path, error)) {
+			files.push_back(path);
+			continue;
+		}
+		if (!fs::is_directory(path, error)) throw std::invalid_argument("No such file in directory: " + path);
+
+		// Недоступные подкаталоги пропускаются
+		const size_t first = files.size();
+		for (fs::recursive_directory_iterator it(path, fs::directory_options::skip_permission_denied, error), end; it != end; it.increment(error)) {
+			if (error) break;
+			if (it->is_regular_file(error)) files.push_back(it->path().string());
+		}
+		std::sort(files.begin() + first, files.end());
+	}
+	return files;
+}
+
+size_t stats_threads(const stats_options& options) {
+	return options.threads != 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+}
+
+std::vector<bool> for_each_file_chunk(const std::vector<std::string>& files, const stats_options& options,
+	size_t before, size_t after, const std::function<void(size_t, const file_chunk&)>& visit) {
+	std::vector<bool> read_error(files.size());
+	std::vector<scan_task> tasks;
+	const uint64_t chunk_size = std::max<uint64_t>(options.chunk_size, 1 << 12);
+
+	for (size_t i{}; i < files.size(); i++) {
+		std::error_code error;
+		const uint64_t size = fs::file_size(files[i], error);
+		if (error) {
+			read_error[i] = true;
+			continue;
+		}
+		for (uint64_t begin{}; begin < size; begin += chunk_size) {
+			tasks.push_back({ i, begin, std::min(size, begin + chunk_size) });
+		}
+	}
+
+	// Крупные части раздаются первыми, чтобы потоки закончили одновременно
+	std::stable_sort(tasks.begin(), tasks.end(), [](const scan_task& a, const scan_task& b) {
+		return a.end - a.begin > b.end - b.begin;
+	});
+
+	const size_t threads = std::max<size_t>(1, std::min(stats_threads(options), tasks.size()));
+	std::vector<std::vector<size_t>> failed(threads);
+	std::atomic<size_t> next{ 0 };
+
+	auto worker = [&](size_t t) {
+		std::vector<unsigned char> buffer;
+		file_chunk chunk{};
+		for (size_t k = next++; k < tasks.size(); k = next++) {
+			if (read_chunk(files[tasks[k].file], tasks[k], before, after, buffer, chunk)) visit(t, chunk);
+			else failed[t].push_back(tasks[k].file);
+		}
+	};
+
+	std::vector<std::thread> pool;
+	for (size_t t{ 1 }; t < threads; t++) pool.emplace_back(worker, t);
+	worker(0);
+	for (std::thread& thread : pool) thread.join();
+
+	for (const std::vector<size_t>& thread_failed : failed) {
+		for (size_t file : thread_failed) read_error[file] = true;
+	}
+	return read_error;
+}
+
+std::vector<file_char_stats> scan_files(const std::vector<std::string>& files, const stats_options& options) {
+	// Гистограммы каждого потока по номерам файлов, складываются после завершения пула
+	std::vector<std::unordered_map<size_t, char_stats>> local(stats_threads(options));
+
+	const std::vector<bool> read_error = for_each_file_chunk(files, options, utf8_margin, utf8_margin,
+		[&](size_t thread, const file_chunk& chunk) {
+			char_stats& stats = local[thread][chunk.file];
+			if (chunk.start < chunk.stop) scan_char_stats(chunk.buf, chunk.size, chunk.start, chunk.stop, stats);
+		});
+
+	std::vector<file_char_stats> result(files.size());
+	for (size_t i{}; i < files.size(); i++) {
+		result[i].path = files[i];
+		result[i].read_error = read_error[i];
+	}
+	for (const auto& thread_stats : local) {
+		for (const auto& [file, stats] : thread_stats) result[file].stats += stats;
+	}
+	return result;
+}
+
+char_stats total_stats(const std::vector<file_char_stats>& files) {
+	char_stats total;
+	for (const file_char_stats& file : files) total += file.stats;
+	return total;
+}
+
+void write_stats_report(const std::vector<file_char_stats>& files, const std::string& report_file) {
+	std::ofstream out(report_file);
+	if (!out.is_open()) throw std::invalid_argument("Access error - unable to create file");
+
+	const char_stats total = total_stats(files);
+	const bool csv = report_file.size() >= 4 && report_file.compare(report_file.size() - 4, 4, ".csv") == 0;
+
+	if (csv) {
+		out << "file";
+		for (const char* name : column_names) out << ',' << name;
+		out << ",error\n";
+
+		for (const file_char_stats& file : files) {
+			write_csv_field(out, file.path);
+			for (uint64_t value : columns(file.stats)) out << ',' << value;
+			out << ',' << file.read_error << '\n';
+		}
+
+		out << "TOTAL";
+		for (uint64_t value : columns(total)) out << ',' << value;
+		out << ",0\n";
+		return;
+	}
+
+	// Итог по всем файлам, затем таблица по файлам
+	const std::vector<uint64_t> total_values = columns(total);
+	out << "files\t" << files.size() << '\n';
+	for (size_t c{}; c < total_values.size(); c++) out << column_names[c] << '\t' << total_values[c] << '\n';
+
+	out << '\n';
+	for (const char* name : column_names) out << name << '\t';
+	out << "file\n";
+	for (const file_char_stats& file : files) {
+		for (uint64_t value : columns(file.stats)) out << value << '\t';
+		out << file.path << (file.read_error ? "\t(read error)" : "") << '\n';
+	}
+}
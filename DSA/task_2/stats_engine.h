@@ -0,0 +1,60 @@
+﻿// Дворников Даниил
+
+#pragma once
+
+#include "char_stats.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+/// Гистограмма одного файла
+struct file_char_stats {
+	std::string path;
+	char_stats stats;
+	/// Файл не удалось открыть или прочитать
+	bool read_error{};
+};
+
+/// Параметры параллельного подсчёта
+struct stats_options {
+	/// Число потоков (0 - по числу ядер)
+	size_t threads{};
+	/// Размер части, на которые делятся большие файлы
+	size_t chunk_size{ 16 << 20 };
+};
+
+/// Часть файла, прочитанная в память: разбираются байты [start, stop) буфера buf размера size,
+/// а байты вне этого диапазона - запас для символов и совпадений на границах частей
+struct file_chunk {
+	size_t file;
+	const unsigned char* buf;
+	size_t size;
+	size_t start;
+	size_t stop;
+};
+
+/// Число потоков пула для options
+size_t stats_threads(const stats_options& options);
+
+/// Делит файлы files на части по chunk_size и разбирает их пулом не более чем из stats_threads(options) потоков:
+/// часть читается вместе с before байтами перед ней и after байтами после неё, и вызывается visit(номер потока, часть).
+/// Возвращает для каждого файла признак ошибки чтения
+std::vector<bool> for_each_file_chunk(const std::vector<std::string>& files, const stats_options& options,
+	size_t before, size_t after, const std::function<void(size_t, const file_chunk&)>& visit);
+
+/// Собирает обычные файлы из списка путей, каталоги обходятся рекурсивно.
+/// Бросает invalid_argument, если путь не существует
+std::vector<std::string> collect_files(const std::vector<std::string>& paths);
+
+/// Считает гистограммы файлов files за один проход пулом потоков: файлы больше chunk_size делятся на части,
+/// которые разбираются независимо (границы частей согласованы с границами символов UTF-8).
+/// Каждый поток копит свои гистограммы, и они складываются после завершения всех потоков
+std::vector<file_char_stats> scan_files(const std::vector<std::string>& files, const stats_options& options = {});
+
+/// Складывает гистограммы всех файлов
+char_stats total_stats(const std::vector<file_char_stats>& files);
+
+/// Записывает отчёт в report_file: CSV, если имя оканчивается на .csv, иначе текстовую таблицу.
+/// Бросает invalid_argument, если файл не создаётся
+void write_stats_report(const std::vector<file_char_stats>& files, const std::string& report_file);
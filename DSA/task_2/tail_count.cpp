@@ -0,0 +1,247 @@
+﻿// Дворников Даниил
+
+#include "tail_count.h"
+#include "utf8_upper.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define TAIL_COUNT_HAS_POSIX 1
+#endif
+
+#if defined(__linux__)
+#include <poll.h>
+#include <sys/inotify.h>
+#endif
+
+namespace {
+
+	/// Заголовок файла контрольной точки
+	const char checkpoint_magic[] = "capital_checkpoint_v1";
+
+	/// Число первых байт файла, по которым считается отпечаток
+	const uint64_t fingerprint_bytes = 4096;
+
+	/// Открытый на чтение файл с доступом по смещению
+	class input_file {
+	public:
+		explicit input_file(const std::string& file_name) {
+#if defined(TAIL_COUNT_HAS_POSIX)
+			fd_ = open(file_name.c_str(), O_RDONLY);
+			if (fd_ < 0) throw std::invalid_argument("No such file in directory");
+#else
+			file_.open(file_name, std::ios::binary);
+			if (!file_.is_open()) throw std::invalid_argument("No such file in directory");
+#endif
+		}
+
+		~input_file() {
+#if defined(TAIL_COUNT_HAS_POSIX)
+			close(fd_);
+#endif
+		}
+
+		input_file(const input_file&) = delete;
+		input_file& operator=(const input_file&) = delete;
+
+		/// Номер индексного дескриптора открытого файла (0 без POSIX)
+		uint64_t inode() const {
+#if defined(TAIL_COUNT_HAS_POSIX)
+			struct stat st {};
+			fstat(fd_, &st);
+			return static_cast<uint64_t>(st.st_ino);
+#else
+			return 0;
+#endif
+		}
+
+		/// Текущий размер файла
+		uint64_t size() {
+#if defined(TAIL_COUNT_HAS_POSIX)
+			struct stat st {};
+			fstat(fd_, &st);
+			return static_cast<uint64_t>(st.st_size);
+#else
+			file_.clear();
+			file_.seekg(0, std::ios::end);
+			return static_cast<uint64_t>(file_.tellg());
+#endif
+		}
+
+		/// Читает до n байт со смещения offset; возвращает число прочитанных байт (0 в конце файла)
+		size_t read_at(uint64_t offset, char* buffer, size_t n) {
+#if defined(TAIL_COUNT_HAS_POSIX)
+			const ssize_t got = pread(fd_, buffer, n, static_cast<off_t>(offset));
+			if (got < 0) throw std::invalid_argument("Read error");
+			return static_cast<size_t>(got);
+#else
+			file_.clear();
+			file_.seekg(static_cast<std::streamoff>(offset));
+			file_.read(buffer, static_cast<std::streamsize>(n));
+			return static_cast<size_t>(file_.gcount());
+#endif
+		}
+
+	private:
+#if defined(TAIL_COUNT_HAS_POSIX)
+		int fd_{ -1 };
+#else
+		std::ifstream file_;
+#endif
+	};
+
+	/// Хеш FNV-1a первых min(size, fingerprint_bytes) байт файла
+	uint64_t head_fingerprint(input_file& file, uint64_t size) {
+		char head[fingerprint_bytes];
+		const size_t n = file.read_at(0, head, static_cast<size_t>(std::min(size, fingerprint_bytes)));
+
+		uint64_t hash{ 14695981039346656037ull };
+		for (size_t i{}; i < n; i++) {
+			hash = (hash ^ static_cast<unsigned char>(head[i])) * 1099511628211ull;
+		}
+		return hash;
+	}
+
+}
+
+bool load_checkpoint(const std::string& checkpoint_file, capital_checkpoint& checkpoint) {
+	std::ifstream in(checkpoint_file);
+	std::string magic;
+	capital_checkpoint loaded;
+	if (!(in >> magic >> loaded.inode >> loaded.size >> loaded.offset >> loaded.count >> loaded.fingerprint)) return false;
+	if (magic != checkpoint_magic || loaded.offset > loaded.size) return false;
+
+	checkpoint = loaded;
+	return true;
+}
+
+void save_checkpoint(const std::string& checkpoint_file, const capital_checkpoint& checkpoint) {
+	const std::string temp_file{ checkpoint_file + ".tmp" };
+	{
+		std::ofstream out(temp_file, std::ios::trunc);
+		if (!out.is_open()) throw std::invalid_argument("Access error - unable to create file");
+		out << checkpoint_magic << '\n' << checkpoint.inode << ' ' << checkpoint.size << ' ' << checkpoint.offset << ' '
+			<< checkpoint.count << ' ' << checkpoint.fingerprint << '\n';
+		if (!out.flush()) throw std::invalid_argument("Access error - unable to create file");
+	}
+
+	// Замена файла целиком: при сбое остаётся прежняя контрольная точка. В отличие от std::rename,
+	// std::filesystem::rename заменяет существующий файл и в Windows
+	std::error_code error;
+	std::filesystem::rename(temp_file, checkpoint_file, error);
+	if (error) throw std::invalid_argument("Access error - unable to create file");
+}
+
+bool update_capital_checkpoint(const std::string& file_name, capital_checkpoint& checkpoint, size_t block_size) {
+	input_file file(file_name);
+	const uint64_t inode = file.inode();
+	const uint64_t size = file.size();
+
+	// Ротация (другой файл под тем же именем), усечение или перезапись начала - пересчёт с нуля
+	const bool rescan = inode != checkpoint.inode || size < checkpoint.size
+		|| head_fingerprint(file, checkpoint.size) != checkpoint.fingerprint;
+	if (rescan) checkpoint = capital_checkpoint{ inode };
+
+	std::vector<char> buffer(std::max<size_t>(block_size, 1));
+	utf8_upper_counter counter;
+	uint64_t end{ checkpoint.offset };
+
+	while (true) {
+		const size_t got = file.read_at(end, buffer.data(), buffer.size());
+		if (got == 0) break;
+		counter.feed(buffer.data(), got);
+		end += got;
+	}
+
+	// Незавершённый символ в конце не учитывается: он будет прочитан заново вместе со своим продолжением
+	checkpoint.count += counter.count();
+	checkpoint.offset = end - counter.pending();
+	checkpoint.size = end;
+	checkpoint.fingerprint = head_fingerprint(file, end);
+	return rescan;
+}
+
+size_t count_capital_incremental(const std::string& file_name, const std::string& checkpoint_file) {
+	capital_checkpoint checkpoint;
+	load_checkpoint(checkpoint_file, checkpoint);
+	update_capital_checkpoint(file_name, checkpoint);
+	save_checkpoint(checkpoint_file, checkpoint);
+	return static_cast<size_t>(checkpoint.count);
+}
+
+void follow_capital_count(const std::string& file_name, const std::string& checkpoint_file,
+	const std::function<bool(size_t)>& on_update, int poll_ms) {
+	capital_checkpoint checkpoint;
+	load_checkpoint(checkpoint_file, checkpoint);
+	capital_checkpoint reported{ checkpoint };
+	bool first{ true };
+
+#if defined(__linux__)
+	// Событие inotify будит цикл сразу после записи; таймаут poll_ms нужен, чтобы заметить новый файл после ротации
+	const int notify = inotify_init1(IN_CLOEXEC | IN_NONBLOCK);
+	int watch{ -1 };
+#endif
+
+	while (true) {
+#if defined(__linux__)
+		if (notify >= 0 && watch < 0) {
+			watch = inotify_add_watch(notify, file_name.c_str(), IN_MODIFY | IN_ATTRIB | IN_MOVE_SELF | IN_DELETE_SELF);
+		}
+#endif
+
+		bool present{ true };
+		try {
+			update_capital_checkpoint(file_name, checkpoint);
+		}
+		catch (std::invalid_argument&) {
+			// Файл удалён, а новый ещё не создан
+			present = false;
+		}
+
+		// Контрольная точка сохраняется при любом продвижении, а сообщение выдаётся только при изменении счётчика
+		if (present && (first || checkpoint.inode != reported.inode || checkpoint.size != reported.size)) {
+			const bool changed = first || checkpoint.inode != reported.inode || checkpoint.count != reported.count;
+			first = false;
+			reported = checkpoint;
+			save_checkpoint(checkpoint_file, checkpoint);
+			if (changed && !on_update(static_cast<size_t>(checkpoint.count))) break;
+		}
+
+#if defined(__linux__)
+		if (notify >= 0) {
+			pollfd request{ notify, POLLIN, 0 };
+			if (poll(&request, 1, poll_ms) > 0) {
+				alignas(inotify_event) char events[4096];
+				ssize_t got;
+				while ((got = read(notify, events, sizeof(events))) > 0) {
+					for (ssize_t pos{}; pos < got;) {
+						const inotify_event* event = reinterpret_cast<const inotify_event*>(events + pos);
+						// Файл переименован или удалён: наблюдение переносится на новый файл с тем же именем
+						if (event->mask & (IN_MOVE_SELF | IN_DELETE_SELF | IN_IGNORED)) {
+							inotify_rm_watch(notify, watch);
+							watch = -1;
+						}
+						pos += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+					}
+				}
+			}
+			continue;
+		}
+#endif
+		std::this_thread::sleep_for(std::chrono::milliseconds(poll_ms));
+	}
+
+#if defined(__linux__)
+	if (notify >= 0) close(notify);
+#endif
+}
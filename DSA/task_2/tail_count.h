@@ -0,0 +1,44 @@
+﻿// Дворников Даниил
+
+#pragma once
+
+#include "file_scan.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+/// Состояние инкрементального подсчёта прописных букв в растущем файле
+struct capital_checkpoint {
+	/// Номер индексного дескриптора файла (0, если система его не сообщает)
+	uint64_t inode{};
+	/// Прочитанный размер файла
+	uint64_t size{};
+	/// Граница разобранного текста: байты после неё (незавершённый символ) читаются заново
+	uint64_t offset{};
+	/// Количество прописных букв до offset
+	uint64_t count{};
+	/// Хеш первых min(size, 4096) байт: по нему замечается перезапись файла с тем же inode
+	uint64_t fingerprint{};
+};
+
+/// Читает контрольную точку из файла checkpoint_file; возвращает false, если файла нет или он повреждён
+bool load_checkpoint(const std::string& checkpoint_file, capital_checkpoint& checkpoint);
+
+/// Записывает контрольную точку в checkpoint_file (через временный файл, чтобы не оставить её недописанной)
+void save_checkpoint(const std::string& checkpoint_file, const capital_checkpoint& checkpoint);
+
+/// Досчитывает прописные буквы в байтах, дописанных в file_name после checkpoint, за время, пропорциональное их объёму.
+/// Если файл заменён (другой inode), укорочен или переписан с начала, он пересчитывается целиком.
+/// Возвращает true при полном пересчёте. Бросает invalid_argument, если файл не открывается
+bool update_capital_checkpoint(const std::string& file_name, capital_checkpoint& checkpoint, size_t block_size = default_scan_block);
+
+/// Считает прописные буквы в file_name, продолжая с контрольной точки checkpoint_file и сохраняя новую
+size_t count_capital_incremental(const std::string& file_name, const std::string& checkpoint_file);
+
+/// Следит за растущим файлом file_name (inotify в Linux, иначе опрос раз в poll_ms миллисекунд)
+/// и после каждого изменения счётчика сохраняет контрольную точку и вызывает on_update(count).
+/// Переименование или удаление файла (ротация журнала) приводит к пересчёту нового файла с тем же именем.
+/// Работа завершается, когда on_update возвращает false
+void follow_capital_count(const std::string& file_name, const std::string& checkpoint_file,
+	const std::function<bool(size_t)>& on_update, int poll_ms = 1000);
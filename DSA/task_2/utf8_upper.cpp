@@ -0,0 +1,385 @@
+﻿// Дворников Даниил
+
+#include "utf8_upper.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+size_t decode_utf8(const unsigned char* s, size_t avail, uint32_t& cp) {
+	const unsigned char b0 = s[0];
+
+	if (b0 < 0x80) {
+		cp = b0;
+		return 1;
+	}
+	// Продолжающий байт без первого или избыточная запись C0 / C1
+	if (b0 < 0xC2) return 0;
+
+	const size_t len = b0 < 0xE0 ? 2 : b0 < 0xF0 ? 3 : b0 < 0xF5 ? 4 : 0;
+	if (len == 0 || len > avail) return 0;
+
+	cp = b0 & (0x7F >> len);
+	for (size_t k{ 1 }; k < len; k++) {
+		if ((s[k] & 0xC0) != 0x80) return 0;
+		cp = (cp << 6) | (s[k] & 0x3F);
+	}
+
+	if ((len == 3 && cp < 0x800) || (len == 4 && (cp < 0x10000 || cp > 0x10FFFF)) || (cp >= 0xD800 && cp <= 0xDFFF)) return 0;
+	return len;
+}
+
+size_t count_upper_scalar(const char* data, size_t n) {
+	const unsigned char* s = reinterpret_cast<const unsigned char*>(data);
+	size_t count{};
+
+	for (size_t i{}; i < n;) {
+		uint32_t cp{};
+		size_t len = decode_utf8(s + i, n - i, cp);
+
+		if (len == 0) {
+			i++;
+			continue;
+		}
+		count += is_upper_code_point(cp);
+		i += len;
+	}
+
+	return count;
+}
+
+/// Битовая таблица прописных букв среди символов с первым байтом lead: бит k - символ с продолжающим байтом 0x80 + k
+constexpr uint64_t upper_row(unsigned lead) {
+	uint64_t row{};
+	for (uint32_t k{}; k < 64; k++) {
+		if (is_upper_code_point(((lead & 0x1F) << 6) | k)) row |= uint64_t{ 1 } << k;
+	}
+	return row;
+}
+
+/// Первые байты двухбайтовых символов, среди которых есть прописные буквы
+constexpr std::array<unsigned char, 10> upper_leads{ 0xC3, 0xC4, 0xC5, 0xCD, 0xCE, 0xCF, 0xD0, 0xD1, 0xD2, 0xD3 };
+
+/// Проверяет, что прописные буквы вне ASCII есть только у первых байтов upper_leads
+constexpr bool upper_leads_complete() {
+	for (unsigned lead{ 0xC2 }; lead < 0xE0; lead++) {
+		bool listed{};
+		for (unsigned char l : upper_leads) listed = listed || l == lead;
+		if (!listed && upper_row(lead) != 0) return false;
+	}
+	for (uint32_t cp{ 0x800 }; cp < 0x10000; cp++) {
+		if (is_upper_code_point(cp)) return false;
+	}
+	return true;
+}
+
+static_assert(upper_leads_complete(), "upper_leads must list every two-byte lead with uppercase letters");
+
+#if defined(__AVX2__)
+
+namespace {
+
+	/// Таблица из 16 байт, повторённая в обеих половинах регистра, для _mm256_shuffle_epi8
+	__m256i table16(std::array<unsigned char, 16> t) {
+		return _mm256_setr_epi8(t[0], t[1], t[2], t[3], t[4], t[5], t[6], t[7], t[8], t[9], t[10], t[11], t[12], t[13], t[14], t[15],
+			t[0], t[1], t[2], t[3], t[4], t[5], t[6], t[7], t[8], t[9], t[10], t[11], t[12], t[13], t[14], t[15]);
+	}
+
+	/// Байты x, сдвинутые на 4 бита вправо
+	__m256i high_nibbles(__m256i x) {
+		return _mm256_and_si256(_mm256_srli_epi16(x, 4), _mm256_set1_epi8(0x0F));
+	}
+
+	/// Байты блока, сдвинутые на N позиций назад, с последними байтами предыдущего блока prev в начале
+	template<int N> __m256i prev_bytes(__m256i input, __m256i prev) {
+		return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev, input, 0x21), 16 - N);
+	}
+
+	/// Проверка UTF-8 по таблицам (алгоритм Кайзера - Лемира): ошибки в парах байтов определяются тремя
+	/// поисками по 4-битным частям, а длины многобайтовых последовательностей - по байтам на 2 и 3 позиции раньше
+	class utf8_checker {
+	public:
+		void check(__m256i input) {
+			if (_mm256_movemask_epi8(input) == 0) {
+				// В блоке ASCII: ошибка, только если предыдущий блок оборвал последовательность
+				error_ = _mm256_or_si256(error_, prev_incomplete_);
+			}
+			else {
+				const __m256i prev1 = prev_bytes<1>(input, prev_);
+				const __m256i special = special_cases(input, prev1);
+				error_ = _mm256_or_si256(error_, multibyte_lengths(input, special));
+				// Последовательность, не завершённая в конце блока
+				prev_incomplete_ = _mm256_subs_epu8(input, _mm256_setr_epi8(
+					-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+					-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, static_cast<char>(0xF0 - 1), static_cast<char>(0xE0 - 1), static_cast<char>(0xC0 - 1)));
+			}
+			prev_ = input;
+		}
+
+		/// Завершает проверку; возвращает true, если ошибок не было
+		bool finish() {
+			error_ = _mm256_or_si256(error_, prev_incomplete_);
+			return _mm256_testz_si256(error_, error_) != 0;
+		}
+
+	private:
+		static constexpr unsigned char too_short = 1 << 0;
+		static constexpr unsigned char too_long = 1 << 1;
+		static constexpr unsigned char overlong_3 = 1 << 2;
+		static constexpr unsigned char too_large = 1 << 3;
+		static constexpr unsigned char surrogate = 1 << 4;
+		static constexpr unsigned char overlong_2 = 1 << 5;
+		static constexpr unsigned char too_large_1000 = 1 << 6;
+		static constexpr unsigned char overlong_4 = 1 << 6;
+		static constexpr unsigned char two_conts = 1 << 7;
+		static constexpr unsigned char carry = too_short | too_long | two_conts;
+
+		/// Ошибки, определяемые парой соседних байтов
+		static __m256i special_cases(__m256i input, __m256i prev1) {
+			const __m256i byte_1_high = _mm256_shuffle_epi8(table16({
+				too_long, too_long, too_long, too_long, too_long, too_long, too_long, too_long,
+				two_conts, two_conts, two_conts, two_conts,
+				too_short | overlong_2,
+				too_short,
+				too_short | overlong_3 | surrogate,
+				too_short | too_large | too_large_1000 | overlong_4 }), high_nibbles(prev1));
+
+			const __m256i byte_1_low = _mm256_shuffle_epi8(table16({
+				carry | overlong_3 | overlong_2 | overlong_4,
+				carry | overlong_2,
+				carry,
+				carry,
+				carry | too_large,
+				carry | too_large | too_large_1000,
+				carry | too_large | too_large_1000,
+				carry | too_large | too_large_1000,
+				carry | too_large | too_large_1000,
+				carry | too_large | too_large_1000,
+				carry | too_large | too_large_1000,
+				carry | too_large | too_large_1000,
+				carry | too_large | too_large_1000,
+				carry | too_large | too_large_1000 | surrogate,
+				carry | too_large | too_large_1000,
+				carry | too_large | too_large_1000 }), _mm256_and_si256(prev1, _mm256_set1_epi8(0x0F)));
+
+			const __m256i byte_2_high = _mm256_shuffle_epi8(table16({
+				too_short, too_short, too_short, too_short, too_short, too_short, too_short, too_short,
+				too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+				too_long | overlong_2 | two_conts | overlong_3 | too_large,
+				too_long | overlong_2 | two_conts | surrogate | too_large,
+				too_long | overlong_2 | two_conts | surrogate | too_large,
+				too_short, too_short, too_short, too_short }), high_nibbles(input));
+
+			return _mm256_and_si256(_mm256_and_si256(byte_1_high, byte_1_low), byte_2_high);
+		}
+
+		/// Сверяет продолжающие байты третьих и четвёртых позиций с ожидаемыми по первым байтам
+		__m256i multibyte_lengths(__m256i input, __m256i special) const {
+			const __m256i prev2 = prev_bytes<2>(input, prev_);
+			const __m256i prev3 = prev_bytes<3>(input, prev_);
+			const __m256i is_third = _mm256_subs_epu8(prev2, _mm256_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+			const __m256i is_fourth = _mm256_subs_epu8(prev3, _mm256_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+			const __m256i must23_80 = _mm256_and_si256(_mm256_or_si256(is_third, is_fourth), _mm256_set1_epi8(static_cast<char>(0x80)));
+			return _mm256_xor_si256(must23_80, special);
+		}
+
+		__m256i error_ = _mm256_setzero_si256();
+		__m256i prev_ = _mm256_setzero_si256();
+		__m256i prev_incomplete_ = _mm256_setzero_si256();
+	};
+
+	/// Битовая таблица первого байта upper_leads[l], разложенная по байтам, для _mm256_shuffle_epi8
+	__m256i row_table(size_t l) {
+		const uint64_t row = upper_row(upper_leads[l]);
+		std::array<unsigned char, 16> t{};
+		for (size_t m{}; m < 8; m++) {
+			t[m] = static_cast<unsigned char>(row >> (8 * m));
+		}
+		return table16(t);
+	}
+
+	/// Считает прописные буквы в блоке input из 32 байт; next - те же байты, сдвинутые на один вперёд.
+	/// Символ учитывается в блоке, где находится его первый байт
+	class upper_counter {
+	public:
+		upper_counter() {
+			for (size_t l{}; l < upper_leads.size(); l++) {
+				rows_[l] = row_table(l);
+			}
+		}
+
+		size_t count(__m256i input, __m256i next) const {
+			const __m256i ascii_upper = _mm256_and_si256(_mm256_cmpgt_epi8(input, _mm256_set1_epi8('A' - 1)),
+				_mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), input));
+			const uint32_t ascii_mask = static_cast<uint32_t>(_mm256_movemask_epi8(ascii_upper));
+
+			if (_mm256_movemask_epi8(input) == 0) return std::popcount(ascii_mask);
+
+			// Байт битовой таблицы и номер бита в нём задаются младшими 6 битами продолжающего байта
+			const __m256i index = _mm256_and_si256(_mm256_srli_epi16(next, 3), _mm256_set1_epi8(7));
+			const __m256i bit = _mm256_shuffle_epi8(table16({ 1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 }),
+				_mm256_and_si256(next, _mm256_set1_epi8(7)));
+
+			// В кириллическом тексте почти все первые байты - D0 и D1
+			const __m256i lead = _mm256_cmpeq_epi8(_mm256_max_epu8(input, _mm256_set1_epi8(static_cast<char>(0xC0))), input);
+			const __m256i cyrillic = _mm256_cmpeq_epi8(_mm256_and_si256(input, _mm256_set1_epi8(static_cast<char>(0xFE))), _mm256_set1_epi8(static_cast<char>(0xD0)));
+			const bool only_cyrillic = _mm256_movemask_epi8(_mm256_andnot_si256(cyrillic, lead)) == 0;
+
+			__m256i selected = _mm256_or_si256(select(input, index, d0_), select(input, index, d0_ + 1));
+			if (!only_cyrillic) {
+				for (size_t l{}; l < upper_leads.size(); l++) {
+					if (l != d0_ && l != d0_ + 1) selected = _mm256_or_si256(selected, select(input, index, l));
+				}
+			}
+
+			const __m256i not_upper = _mm256_cmpeq_epi8(_mm256_and_si256(selected, bit), _mm256_setzero_si256());
+			const uint32_t multibyte_mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(not_upper));
+
+			return std::popcount(ascii_mask | multibyte_mask);
+		}
+
+	private:
+		/// Байты битовой таблицы для позиций блока, где стоит первый байт upper_leads[l] (остальные позиции - нули)
+		__m256i select(__m256i input, __m256i index, size_t l) const {
+			const __m256i is_lead = _mm256_cmpeq_epi8(input, _mm256_set1_epi8(static_cast<char>(upper_leads[l])));
+			return _mm256_and_si256(is_lead, _mm256_shuffle_epi8(rows_[l], index));
+		}
+
+		/// Номер первого байта D0 в upper_leads (за ним идёт D1)
+		static constexpr size_t d0_ = 6;
+		static_assert(upper_leads[d0_] == 0xD0 && upper_leads[d0_ + 1] == 0xD1);
+
+		__m256i rows_[upper_leads.size()];
+	};
+
+	/// Проверяет и считает data размера n блоками по 32 байта; возвращает false для недопустимого текста
+	bool simd_count_upper(const unsigned char* data, size_t n, size_t& count) {
+		utf8_checker checker;
+		upper_counter counter;
+		size_t i{};
+		count = 0;
+
+		// Блоку нужен следующий за ним байт
+		for (; i + 33 <= n; i += 32) {
+			const __m256i input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+			checker.check(input);
+			count += counter.count(input, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i + 1)));
+		}
+
+		// Остаток дополняется нулями: они допустимы в UTF-8 и не являются прописными
+		alignas(32) unsigned char tail[64]{};
+		std::memcpy(tail, data + i, n - i);
+		const __m256i input = _mm256_load_si256(reinterpret_cast<const __m256i*>(tail));
+		checker.check(input);
+		count += counter.count(input, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tail + 1)));
+
+		return checker.finish();
+	}
+
+}
+
+#endif
+
+bool validate_utf8(const char* data, size_t n) {
+#if defined(__AVX2__)
+	size_t count{};
+	return simd_count_upper(reinterpret_cast<const unsigned char*>(data), n, count);
+#else
+	const unsigned char* s = reinterpret_cast<const unsigned char*>(data);
+	for (size_t i{}; i < n;) {
+		uint32_t cp{};
+		size_t len = decode_utf8(s + i, n - i, cp);
+		if (len == 0) return false;
+		i += len;
+	}
+	return true;
+#endif
+}
+
+size_t count_upper_utf8(const char* data, size_t n) {
+#if defined(__AVX2__)
+	size_t count{};
+	if (simd_count_upper(reinterpret_cast<const unsigned char*>(data), n, count)) return count;
+#endif
+	return count_upper_scalar(data, n);
+}
+
+/// Длина последовательности UTF-8 по первому байту lead (0 - байт не может начинать многобайтовый символ)
+static size_t utf8_lead_length(unsigned char lead) {
+	if (lead < 0xC0) return 0;
+	return lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : 4;
+}
+
+void utf8_upper_counter::feed(const char* data, size_t n) {
+	const unsigned char* s = reinterpret_cast<const unsigned char*>(data);
+	size_t offset{};
+
+	// Символы, начатые в предыдущем блоке, разбираются во временном буфере вместе с началом этого блока
+	if (carry_size_ > 0) {
+		unsigned char joined[8];
+		const size_t taken = std::min<size_t>(n, 3);
+		std::memcpy(joined, carry_, carry_size_);
+		std::memcpy(joined + carry_size_, s, taken);
+		const size_t joined_size = carry_size_ + taken;
+
+		size_t pos{};
+		while (pos < carry_size_) {
+			const size_t len = utf8_lead_length(joined[pos]);
+
+			// Все доступные байты - продолжающие, но их меньше, чем нужно: символ ждёт следующего блока
+			if (len > joined_size - pos) {
+				bool continuation{ true };
+				for (size_t k{ pos + 1 }; k < joined_size; k++) {
+					continuation = continuation && (joined[k] & 0xC0) == 0x80;
+				}
+				if (continuation) {
+					std::memmove(carry_, joined + pos, joined_size - pos);
+					carry_size_ = joined_size - pos;
+					return;
+				}
+			}
+
+			uint32_t cp{};
+			const size_t decoded = decode_utf8(joined + pos, joined_size - pos, cp);
+			if (decoded == 0) {
+				pos++;
+			}
+			else {
+				count_ += is_upper_code_point(cp);
+				pos += decoded;
+			}
+		}
+
+		offset = pos - carry_size_;
+		carry_size_ = 0;
+	}
+
+	if (offset >= n) return;
+
+	// Последний первый байт многобайтового символа среди 3 последних байтов блока: если символ не помещается, он переносится
+	size_t cut{ n };
+	const size_t window_start = std::max(offset, n >= 3 ? n - 3 : size_t{});
+	for (size_t i{ n }; i > window_start; i--) {
+		const size_t lead = i - 1;
+		const size_t len = utf8_lead_length(s[lead]);
+		if (len != 0) {
+			if (lead + len > n) cut = lead;
+			break;
+		}
+	}
+
+	count_ += count_upper_utf8(data + offset, cut - offset);
+	std::memcpy(carry_, s + cut, n - cut);
+	carry_size_ = n - cut;
+}
+
+size_t utf8_upper_counter::finish() {
+	count_ += count_upper_scalar(reinterpret_cast<const char*>(carry_), carry_size_);
+	carry_size_ = 0;
+	return count_;
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+﻿// Дворников Даниил
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/// Проверяет, является ли символ с кодом cp прописной буквой латиницы (ASCII, Latin-1, Latin Extended-A),
+/// греческого алфавита (U+0370 - U+03FF) или кириллицы (U+0400 - U+04FF)
+constexpr bool is_upper_code_point(uint32_t cp) {
+	if (cp < 0x80) return cp >= 'A' && cp <= 'Z';
+	if (cp < 0x100) return cp >= 0xC0 && cp <= 0xDE && cp != 0xD7;
+
+	// Latin Extended-A: пары "прописная - строчная"
+	if (cp < 0x180) {
+		if (cp <= 0x137) return cp % 2 == 0;
+		if (cp == 0x138) return false;
+		if (cp <= 0x148) return cp % 2 == 1;
+		if (cp == 0x149) return false;
+		if (cp <= 0x177) return cp % 2 == 0;
+		if (cp == 0x178) return true;
+		return cp <= 0x17E && cp % 2 == 1;
+	}
+
+	// Греческий и коптский
+	if (cp >= 0x370 && cp < 0x400) {
+		if (cp < 0x380) return cp == 0x370 || cp == 0x372 || cp == 0x376 || cp == 0x37F;
+		if (cp < 0x391) return cp == 0x386 || (cp >= 0x388 && cp <= 0x38A) || cp == 0x38C || cp == 0x38E || cp == 0x38F;
+		if (cp <= 0x3AB) return cp != 0x3A2;
+		if (cp < 0x3CF) return false;
+		if (cp == 0x3CF) return true;
+		if (cp < 0x3D8) return cp >= 0x3D2 && cp <= 0x3D4;
+		if (cp <= 0x3EF) return cp % 2 == 0;
+		return cp == 0x3F4 || cp == 0x3F7 || cp == 0x3F9 || cp == 0x3FA || cp >= 0x3FD;
+	}
+
+	// Кириллица
+	if (cp >= 0x400 && cp < 0x500) {
+		if (cp < 0x430) return true;
+		if (cp < 0x460) return false;
+		if (cp < 0x482) return cp % 2 == 0;
+		if (cp < 0x48A) return false;
+		if (cp < 0x4C0) return cp % 2 == 0;
+		if (cp == 0x4C0) return true;
+		if (cp < 0x4CF) return cp % 2 == 1;
+		if (cp == 0x4CF) return false;
+		return cp % 2 == 0;
+	}
+
+	return false;
+}
+
+/// Декодирует символ UTF-8 в начале s (доступно avail байт) в код cp; возвращает длину символа в байтах
+/// или 0 для недопустимой последовательности (лишний продолжающий байт, избыточная запись, суррогат, код больше U+10FFFF)
+size_t decode_utf8(const unsigned char* s, size_t avail, uint32_t& cp);
+
+/// Считает прописные буквы в тексте UTF-8 data размера n посимвольным декодированием (эталонная реализация);
+/// недопустимые байты пропускаются по одному
+size_t count_upper_scalar(const char* data, size_t n);
+
+/// Проверяет, что data размера n - допустимый текст UTF-8
+bool validate_utf8(const char* data, size_t n);
+
+/// Считает прописные буквы в тексте UTF-8 data размера n. С AVX2 текст проверяется и разбирается блоками по 32 байта:
+/// ASCII сравнивается с диапазоном 'A'-'Z', двухбайтовые символы - по битовым таблицам для каждого первого байта.
+/// Результат совпадает с count_upper_scalar (недопустимый текст считается эталонной реализацией)
+size_t count_upper_utf8(const char* data, size_t n);
+
+/// Потоковый подсчёт прописных букв: текст подаётся блоками произвольного размера, а символ UTF-8,
+/// разрезанный границей блоков, дожидается следующего блока (хранится не больше 3 байт).
+/// Результат совпадает с count_upper_scalar для всего текста целиком
+class utf8_upper_counter {
+public:
+	/// Добавляет очередной блок data размера n
+	void feed(const char* data, size_t n);
+
+	/// Завершает текст (недописанный символ в конце - недопустимые байты) и возвращает количество прописных букв
+	size_t finish();
+
+	/// Количество прописных букв в поданном тексте без учёта незавершённого символа в конце
+	size_t count() const {
+		return count_;
+	}
+
+	/// Число байт незавершённого символа в конце поданного текста
+	size_t pending() const {
+		return carry_size_;
+	}
+
+private:
+	unsigned char carry_[4]{};
+	size_t carry_size_{};
+	size_t count_{};
+};
\ No newline at end of file
@@ -1,5 +1,6 @@
 ﻿#include <iostream>
 #include "lib.h"
+#include "exact_sum.h"
 
 /*
 
@@ -22,5 +23,21 @@ int main() {
     unsigned long long result = parallel_sum(n);
     std::cout << "The sum is: " << result << "\n";
 
+    // Точное значение без переполнения
+    char exact = 'n';
+    std::cout << "Compute exact value? (y/n): ";
+    std::cin >> exact;
+    if (exact == 'y') {
+        std::cout << "The exact sum is: " << exact_parallel_sum(n) << "\n";
+    }
+
+    // Сравнение способов распределения слагаемых между потоками
+    char answer = 'n';
+    std::cout << "Run scheduling benchmark? (y/n): ";
+    std::cin >> answer;
+    if (answer == 'y') {
+        benchmark_schedules(n);
+    }
+
     return 0;
 }
\ No newline at end of file
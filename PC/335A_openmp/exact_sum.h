@@ -0,0 +1,152 @@
+#pragma once
+#include <omp.h>
+#include <vector>
+#include <mutex>
+#include <unordered_map>
+#include <boost/multiprecision/cpp_int.hpp>
+#include "lib.h"
+
+///   
+using BigInt = boost::multiprecision::cpp_int;
+
+///  ,     
+constexpr unsigned long long product_leaf_size = 64;
+
+///   ,     OpenMP
+constexpr int product_task_depth = 4;
+
+/// <summary>
+///    :      k  
+/// </summary>
+class ExactTermCache {
+public:
+    /// <summary>
+    ///   k  
+    /// </summary>
+    /// <param name="k"> </param>
+    /// <param name="value">  </param>
+    /// <returns>true,   </returns>
+    bool find(unsigned long long k, BigInt& value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = terms_.find(k);
+        if (it == terms_.end()) return false;
+        value = it->second;
+        return true;
+    }
+
+    /// <summary>
+    ///   k
+    /// </summary>
+    void store(unsigned long long k, const BigInt& value) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        terms_.emplace(k, value);
+    }
+
+    /// <summary>
+    ///   
+    /// </summary>
+    size_t size() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return terms_.size();
+    }
+
+private:
+    std::mutex mutex_;
+    std::unordered_map<unsigned long long, BigInt> terms_;
+};
+
+/// <summary>
+///    i  lo  hi  :
+///   ,   ,  
+///       .   
+///     OpenMP.
+/// </summary>
+/// <param name="lo"> </param>
+/// <param name="hi"> </param>
+/// <param name="depth">   </param>
+/// <returns></returns>
+inline BigInt range_product(unsigned long long lo, unsigned long long hi, int depth = product_task_depth) {
+    if (lo > hi) return 1;
+    if (hi - lo < product_leaf_size) {
+        //  :    64- ,   
+        BigInt result = 1;
+        unsigned long long acc = 1;
+        for (unsigned long long i = lo; i <= hi; i++) {
+            if (acc > ULLONG_MAX / i) {
+                result *= acc;
+                acc = 1;
+            }
+            acc *= i;
+        }
+        result *= acc;
+        return result;
+    }
+
+    unsigned long long mid = lo + (hi - lo) / 2;
+    BigInt left, right;
+    if (depth > 0) {
+        //    
+        #pragma omp task shared(left)
+        left = range_product(lo, mid, depth - 1);
+        right = range_product(mid + 1, hi, depth - 1);
+        #pragma omp taskwait
+    }
+    else {
+        left = range_product(lo, mid, 0);
+        right = range_product(mid + 1, hi, 0);
+    }
+    return left * right;
+}
+
+/// <summary>
+///    :  i  k  k^2
+/// </summary>
+/// <param name="k"> </param>
+/// <param name="cache">  </param>
+/// <returns>  </returns>
+inline BigInt exact_term(unsigned long long k, ExactTermCache* cache = nullptr) {
+    BigInt value;
+    if (cache && cache->find(k, value)) return value;
+    value = range_product(k, k * k);
+    if (cache) cache->store(k, value);
+    return value;
+}
+
+/// <summary>
+///      .
+///     (   ),
+///   -   ,  
+///    .
+/// </summary>
+/// <param name="n">    1  n</param>
+/// <param name="cache">   </param>
+/// <returns>  </returns>
+inline BigInt exact_parallel_sum(unsigned int n, ExactTermCache* cache = nullptr) {
+    // n   int     :  
+    if (n == 0 || n > static_cast<unsigned int>(INT_MAX)) return 0;
+
+    std::vector<BigInt> terms(n);
+    #pragma omp parallel
+    #pragma omp single
+    {
+        //    ,      
+        for (unsigned long long k = n; k >= 1; k--) {
+            #pragma omp task firstprivate(k) shared(terms)
+            terms[k - 1] = exact_term(k, cache);
+        }
+        #pragma omp taskwait
+    }
+
+    //  :        step
+    for (size_t step = 1; step < terms.size(); step *= 2) {
+        long long pairs = static_cast<long long>((terms.size() + 2 * step - 1) / (2 * step));
+        #pragma omp parallel for schedule(dynamic)
+        for (long long p = 0; p < pairs; p++) {
+            size_t i = static_cast<size_t>(p) * 2 * step;
+            if (i + step < terms.size()) {
+                terms[i] += terms[i + step];
+            }
+        }
+    }
+    return terms[0];
+}
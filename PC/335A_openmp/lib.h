@@ -1,28 +1,321 @@
 #pragma once
 #include <omp.h>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#include <climits>
+#include <array>
+#include <mutex>
+
+/// <summary>
+///      
+/// </summary>
+enum class SumSchedule {
+    Static,   // schedule(static):     
+    Dynamic,  // schedule(dynamic):     
+    Guided,   // schedule(guided):   
+    Balanced  //        
+};
+
+/// <summary>
+///      
+/// </summary>
+struct SumStats {
+    std::vector<double> busySeconds; //    , 
+};
+
+/// <summary>
+///   :  i  k  k^2 (  2^64)
+/// </summary>
+/// <param name="k"> </param>
+/// <returns></returns>
+constexpr unsigned long long sum_term(unsigned long long k) {
+    unsigned long long temp = 1;
+    //  64-: k * k     unsigned int k
+    for (unsigned long long i = k; i <= k * k; i++) {
+        temp *= i;
+    }
+    return temp;
+}
+
+/// <summary>
+///     m!   : m - (     m)
+/// </summary>
+/// <param name="m"> </param>
+/// <returns>  2  m!</returns>
+constexpr unsigned long long factorial_two_adic(unsigned long long m) {
+    unsigned long long ones = 0;
+    for (unsigned long long x = m; x != 0; x >>= 1) ones += x & 1;
+    return m - ones;
+}
+
+/// <summary>
+///   2   k:  i  k  k^2  (k^2)! / (k - 1)!
+/// </summary>
+/// <param name="k"> </param>
+/// <returns>    </returns>
+constexpr unsigned long long term_two_adic(unsigned long long k) {
+    return factorial_two_adic(k * k) - factorial_two_adic(k - 1);
+}
+
+/// <summary>
+///   ,      2^64.
+///   64    2  ,  term_two_adic  :
+///    k + 1    k      k.
+/// </summary>
+/// <returns> k,    64  2 ( 8)</returns>
+constexpr unsigned long long last_nonzero_term() {
+    unsigned long long k = 1;
+    while (term_two_adic(k + 1) < 64) k++;
+    return k;
+}
+
+static_assert(last_nonzero_term() == 8, "terms k >= 9 vanish modulo 2^64");
+
+/// <summary>
+///    1..m:  (k^2 - k + 1) = (m^3 + 2m) / 3
+/// </summary>
+/// <param name="m">  </param>
+/// <returns>    1..m</returns>
+inline long double sum_cost(unsigned long long m) {
+    long double x = static_cast<long double>(m);
+    return (x * x * x + 2 * x) / 3;
+}
+
+/// <summary>
+///   1..n  parts      .
+///        sum_cost.
+/// </summary>
+/// <param name="n">  </param>
+/// <param name="parts"> </param>
+/// <returns> :  t   [bounds[t], bounds[t + 1])</returns>
+inline std::vector<unsigned long long> balanced_partition(unsigned long long n, unsigned int parts) {
+    std::vector<unsigned long long> bounds(parts + 1);
+    bounds[0] = 1;
+    long double total = sum_cost(n);
+    for (unsigned int t = 1; t < parts; t++) {
+        long double target = total * t / parts;
+        //  m,     1..m    t / parts
+        unsigned long long lo = bounds[t - 1] - 1, hi = n;
+        while (lo < hi) {
+            unsigned long long mid = lo + (hi - lo) / 2;
+            if (sum_cost(mid) < target) lo = mid + 1;
+            else hi = mid;
+        }
+        bounds[t] = lo + 1;
+    }
+    bounds[parts] = n + 1;
+    return bounds;
+}
 
 /// <summary>
 ///     
 /// </summary>
 /// <param name="n">    1  n</param>
+/// <param name="schedule">    </param>
+/// <param name="stats">     </param>
+/// <param name="skip_zero_terms">  ,     2^64 (k  8)</param>
 /// <returns> </returns>
-unsigned long long parallel_sum(unsigned int n) {
+inline unsigned long long parallel_sum(unsigned int n, SumSchedule schedule = SumSchedule::Balanced, SumStats* stats = nullptr,
+    bool skip_zero_terms = true) {
     unsigned long long sum = 0;
-    
+    int threads = omp_get_max_threads();
+    if (stats) stats->busySeconds.assign(threads, 0.0);
+
+    // n   int     :  
+    if (n > static_cast<unsigned int>(INT_MAX)) return 0;
+    //   k > 8    64  2   ,
+    //     n      8 
+    if (skip_zero_terms) n = static_cast<unsigned int>(std::min<unsigned long long>(n, last_nonzero_term()));
+
+    if (schedule == SumSchedule::Balanced) {
+        //   k  k^2 - k + 1 ,     
+        //   .      .
+        //    :      ,  
+        std::vector<unsigned long long> bounds;
+        #pragma omp parallel num_threads(threads) reduction(+:sum)
+        {
+            #pragma omp single
+            bounds = balanced_partition(n, omp_get_num_threads());
+            int id = omp_get_thread_num();
+            double start = omp_get_wtime();
+            for (unsigned long long k = bounds[id]; k < bounds[id + 1]; k++) {
+                sum += sum_term(k);
+            }
+            if (stats) stats->busySeconds[id] = omp_get_wtime() - start;
+        }
+        return sum;
+    }
+
     // #pragma omp parallel -   ,          .
-    //         for.      .
+    //         for.     .
     //       ,    omp_set_num_threads()
     // reduciton -      sum,      
-    #pragma omp parallel for reduction(+:sum)
-    for (int k = 1; k <= n; k++) {
-        unsigned long long temp = 1;
+    #pragma omp parallel num_threads(threads) reduction(+:sum)
+    {
+        double busy = 0;
+        auto add_term = [&](long long k) {
+            double start = stats ? omp_get_wtime() : 0;
+            sum += sum_term(k);
+            if (stats) busy += omp_get_wtime() - start;
+        };
+        //     ,      omp_set_schedule
+        if (schedule == SumSchedule::Dynamic) {
+            #pragma omp for schedule(dynamic) nowait
+            for (long long k = 1; k <= static_cast<long long>(n); k++) add_term(k);
+        }
+        else if (schedule == SumSchedule::Guided) {
+            #pragma omp for schedule(guided) nowait
+            for (long long k = 1; k <= static_cast<long long>(n); k++) add_term(k);
+        }
+        else {
+            #pragma omp for schedule(static) nowait
+            for (long long k = 1; k <= static_cast<long long>(n); k++) add_term(k);
+        }
+        if (stats) stats->busySeconds[omp_get_thread_num()] = busy;
+    }
+
+    return sum;
+}
+
+///   ,    
+constexpr unsigned int small_sum_table_size = 64;
+
+/// <summary>
+///      n  0  small_sum_table_size   
+/// </summary>
+/// <returns>:  n  parallel_sum(n)</returns>
+constexpr std::array<unsigned long long, small_sum_table_size + 1> make_small_sum_table() {
+    std::array<unsigned long long, small_sum_table_size + 1> table{};
+    for (unsigned int n = 1; n <= small_sum_table_size; n++) {
+        //    ,    
+        table[n] = table[n - 1] + (n <= last_nonzero_term() ? sum_term(n) : 0);
+    }
+    return table;
+}
+
+///     n:   
+constexpr auto small_sum_table = make_small_sum_table();
 
-        for (int i = k; i <= k * k; i++) {
-            temp *= i;
+static_assert(small_sum_table[7] == 7272256138021242073ULL, "compile-time table matches parallel_sum");
+
+/// <summary>
+///       .
+///          ;
+///   n     .
+/// </summary>
+class PrefixSumTable {
+public:
+    /// <summary>
+    ///     n,    
+    /// </summary>
+    /// <param name="n">    1  n</param>
+    /// <returns> </returns>
+    unsigned long long query(unsigned int n) {
+        if (n > static_cast<unsigned int>(INT_MAX)) return 0; //   
+        if (n <= small_sum_table_size) return small_sum_table[n];
+        std::lock_guard<std::mutex> lock(mutex_);
+        unsigned long long k = effective_n(n);
+        extend(k);
+        return prefix_[k];
+    }
+
+    /// <summary>
+    ///    ,       n
+    /// </summary>
+    /// <param name="ns">  n</param>
+    /// <returns>    </returns>
+    std::vector<unsigned long long> query_batch(const std::vector<unsigned int>& ns) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        unsigned long long maxN = 0;
+        for (unsigned int n : ns) {
+            if (n <= static_cast<unsigned int>(INT_MAX)) maxN = std::max(maxN, effective_n(n));
         }
+        extend(maxN);
 
-        sum += temp;
+        std::vector<unsigned long long> result(ns.size());
+        for (size_t i = 0; i < ns.size(); i++) {
+            result[i] = ns[i] > static_cast<unsigned int>(INT_MAX) ? 0 : prefix_[effective_n(ns[i])];
+        }
+        return result;
     }
 
-    return sum;
-}
\ No newline at end of file
+    /// <summary>
+    ///    
+    /// </summary>
+    size_t size() const {
+        return prefix_.size() - 1;
+    }
+
+private:
+    /// <summary>
+    ///   ,   :   k  8  
+    /// </summary>
+    static unsigned long long effective_n(unsigned int n) {
+        return std::min<unsigned long long>(n, last_nonzero_term());
+    }
+
+    /// <summary>
+    ///     n 
+    /// </summary>
+    void extend(unsigned long long n) {
+        size_t first = prefix_.size();
+        if (n < first) return;
+
+        //    
+        std::vector<unsigned long long> terms(n + 1 - first);
+        #pragma omp parallel for schedule(dynamic)
+        for (long long i = 0; i < static_cast<long long>(terms.size()); i++) {
+            terms[i] = sum_term(first + i);
+        }
+
+        //     
+        prefix_.resize(n + 1);
+        for (size_t i = 0; i < terms.size(); i++) {
+            prefix_[first + i] = prefix_[first + i - 1] + terms[i];
+        }
+    }
+
+    std::mutex mutex_;
+    std::vector<unsigned long long> prefix_ = { 0 }; // prefix_[k] -   1..k
+};
+
+/// <summary>
+///       n     
+/// </summary>
+/// <param name="ns">  n</param>
+/// <returns>    </returns>
+inline std::vector<unsigned long long> parallel_sum_batch(const std::vector<unsigned int>& ns) {
+    PrefixSumTable table;
+    return table.query_batch(ns);
+}
+
+/// <summary>
+///         
+/// </summary>
+/// <param name="n">    1  n</param>
+inline void benchmark_schedules(unsigned int n) {
+    const std::pair<SumSchedule, const char*> schedules[] = {
+        { SumSchedule::Static, "static" },
+        { SumSchedule::Dynamic, "dynamic" },
+        { SumSchedule::Guided, "guided" },
+        { SumSchedule::Balanced, "balanced" },
+    };
+    for (const auto& [schedule, name] : schedules) {
+        SumStats stats;
+        double start = omp_get_wtime();
+        //    ,     
+        unsigned long long result = parallel_sum(n, schedule, &stats, false);
+        double total = omp_get_wtime() - start;
+
+        // :      
+        double maxBusy = *std::max_element(stats.busySeconds.begin(), stats.busySeconds.end());
+        double sumBusy = 0;
+        for (double busy : stats.busySeconds) sumBusy += busy;
+        double meanBusy = sumBusy / stats.busySeconds.size();
+
+        std::cout << name << ": total " << total * 1000 << " ms, sum " << result << "\n  busy per thread (ms):";
+        for (double busy : stats.busySeconds) std::cout << " " << busy * 1000;
+        std::cout << "\n  imbalance (max / mean): " << (meanBusy > 0 ? maxBusy / meanBusy : 1.0) << "\n";
+    }
+}
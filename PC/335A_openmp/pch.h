@@ -6,3 +6,4 @@
 
 #include "gtest/gtest.h"
 #include "../OpenMP_335A/lib.h"
+#include "../OpenMP_335A/exact_sum.h"
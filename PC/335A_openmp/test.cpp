@@ -10,4 +10,84 @@ TEST(ParallelSumTest, TestSmallN) {
 TEST(ParallelSumTest, TestZeroAndNegativeN) {
     EXPECT_EQ(parallel_sum(0LL), 0);
     EXPECT_EQ(parallel_sum(-1LL), 0);
-}
\ No newline at end of file
+}
+//       
+TEST(ParallelSumTest, BalancedPartitionEqualCost) {
+    auto bounds = balanced_partition(1000, 4);
+    ASSERT_EQ(bounds.size(), 5u);
+    EXPECT_EQ(bounds.front(), 1u);
+    EXPECT_EQ(bounds.back(), 1001u);
+    long double quarter = sum_cost(1000) / 4;
+    for (size_t t = 0; t + 1 < bounds.size(); t++) {
+        long double cost = sum_cost(bounds[t + 1] - 1) - sum_cost(bounds[t] - 1);
+        //           
+        EXPECT_NEAR(static_cast<double>(cost), static_cast<double>(quarter), 1000.0 * 1000.0);
+    }
+}
+
+TEST(ParallelSumTest, SchedulesAgree) {
+    for (SumSchedule schedule : { SumSchedule::Static, SumSchedule::Dynamic, SumSchedule::Guided, SumSchedule::Balanced }) {
+        EXPECT_EQ(parallel_sum(7, schedule), 7272256138021242073ULL);
+        EXPECT_EQ(parallel_sum(40, schedule), parallel_sum(40, SumSchedule::Static));
+    }
+}
+
+//    
+TEST(ParallelSumTest, VanishingTerms) {
+    EXPECT_EQ(term_two_adic(8), 59u);
+    EXPECT_EQ(term_two_adic(9), 71u);
+    EXPECT_NE(sum_term(8), 0u);
+    EXPECT_EQ(sum_term(9), 0u);
+    EXPECT_EQ(sum_term(20), 0u);
+    //       
+    EXPECT_EQ(parallel_sum(30), parallel_sum(30, SumSchedule::Static, nullptr, false));
+    //  n   ,  n = 8
+    EXPECT_EQ(parallel_sum(2000000000u), parallel_sum(8));
+}
+
+//   
+TEST(ExactSumTest, SmallValues) {
+    EXPECT_EQ(exact_parallel_sum(0), 0);
+    EXPECT_EQ(exact_parallel_sum(3), 181465);
+    // 4 * 5 * ... * 16 = 16! / 3!
+    EXPECT_EQ(exact_term(4), BigInt(3487131648000ULL));
+    EXPECT_EQ(exact_parallel_sum(4), BigInt(181465) + BigInt(3487131648000ULL));
+}
+
+TEST(ExactSumTest, MatchesModularSum) {
+    ExactTermCache cache;
+    for (unsigned int n = 1; n <= 12; n++) {
+        BigInt exact = exact_parallel_sum(n, &cache);
+        EXPECT_EQ(static_cast<unsigned long long>(exact & BigInt(ULLONG_MAX)), parallel_sum(n)) << "n = " << n;
+    }
+    EXPECT_EQ(cache.size(), 12u);
+}
+
+TEST(ExactSumTest, ProductTreeMatchesSequential) {
+    BigInt expected = 1;
+    for (unsigned long long i = 1000; i <= 5000; i++) expected *= i;
+    EXPECT_EQ(range_product(1000, 5000), expected);
+}
+
+//   
+TEST(PrefixSumTableTest, BatchMatchesSingleQueries) {
+    std::vector<unsigned int> ns = { 7, 0, 3, 100, 1, 2, 5000000, 8, 9 };
+    std::vector<unsigned long long> result = parallel_sum_batch(ns);
+    ASSERT_EQ(result.size(), ns.size());
+    for (size_t i = 0; i < ns.size(); i++) {
+        EXPECT_EQ(result[i], parallel_sum(ns[i])) << "n = " << ns[i];
+    }
+}
+
+TEST(PrefixSumTableTest, IncrementalAndCompileTimeTable) {
+    PrefixSumTable table;
+    EXPECT_EQ(table.query(3), 181465u);
+    EXPECT_EQ(table.query(7), 7272256138021242073u);
+    EXPECT_EQ(table.query(1000), parallel_sum(1000));
+    //    ,   
+    EXPECT_EQ(table.size(), static_cast<size_t>(last_nonzero_term()));
+    EXPECT_EQ(table.query(static_cast<unsigned int>(-1)), 0u);
+    for (unsigned int n = 0; n <= small_sum_table_size; n++) {
+        EXPECT_EQ(small_sum_table[n], parallel_sum(n)) << "n = " << n;
+    }
+}
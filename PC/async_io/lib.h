@@ -0,0 +1,451 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define ASYNC_IO_HAS_PREAD 1
+#else
+#define ASYNC_IO_HAS_PREAD 0
+#endif
+
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <cerrno>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#define ASYNC_IO_HAS_URING 1
+#else
+#define ASYNC_IO_HAS_URING 0
+#endif
+
+/// <summary>
+///   .
+/// </summary>
+enum class AsyncBackend {
+    Uring,  // io_uring:    
+    Pread,  //  pread   
+    Stream  // std::ifstream (  POSIX)
+};
+
+/// <summary>
+///    .
+/// </summary>
+inline const char* backendName(AsyncBackend backend) {
+    switch (backend) {
+    case AsyncBackend::Uring: return "io_uring";
+    case AsyncBackend::Pread: return "pread";
+    default: return "ifstream";
+    }
+}
+
+/// <summary>
+///   .
+/// </summary>
+struct AsyncReadOptions {
+    size_t blockSize = 1 << 20; //    (  )
+    size_t queueDepth = 8;      //  ,  
+    bool useUring = true;       // false -   
+};
+
+/// <summary>
+///   :   ,    .
+///      ,      .
+/// </summary>
+using BlockCallback = std::function<void(uint64_t offset, const char* data, size_t size)>;
+
+/// <summary>
+///       .
+/// </summary>
+class AlignedBuffer {
+public:
+    static constexpr size_t alignment = 4096;
+
+    explicit AlignedBuffer(size_t size)
+        : data_(static_cast<char*>(::operator new[](std::max<size_t>(size, 1), std::align_val_t(alignment)))), size_(size) {}
+
+    ~AlignedBuffer() {
+        ::operator delete[](data_, std::align_val_t(alignment));
+    }
+
+    AlignedBuffer(const AlignedBuffer&) = delete;
+    AlignedBuffer& operator=(const AlignedBuffer&) = delete;
+
+    char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    char* data_;
+    size_t size_;
+};
+
+#if ASYNC_IO_HAS_URING
+/// <summary>
+///  io_uring     liburing:        ,
+///            io_uring_enter.
+/// </summary>
+class UringQueue {
+public:
+    /// <summary>
+    ///    entries .   ( ,   ) ok()  false.
+    /// </summary>
+    explicit UringQueue(unsigned entries) {
+        io_uring_params params{};
+        ringFd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (ringFd_ < 0) return;
+
+        sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        //   Linux 5.4      mmap
+        bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMap) sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+
+        sqRing_ = mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQ_RING);
+        if (sqRing_ == MAP_FAILED) {
+            sqRing_ = nullptr;
+            return;
+        }
+        cqRing_ = singleMap ? sqRing_
+            : mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_CQ_RING);
+        if (cqRing_ == MAP_FAILED) {
+            cqRing_ = nullptr;
+            return;
+        }
+        sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) return;
+        sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+        char* sq = static_cast<char*>(sqRing_);
+        sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+        char* cq = static_cast<char*>(cqRing_);
+        cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    }
+
+    ~UringQueue() {
+        if (sqes_) munmap(sqes_, sqesSize_);
+        if (cqRing_ && cqRing_ != sqRing_) munmap(cqRing_, cqRingSize_);
+        if (sqRing_) munmap(sqRing_, sqRingSize_);
+        if (ringFd_ >= 0) close(ringFd_);
+    }
+
+    UringQueue(const UringQueue&) = delete;
+    UringQueue& operator=(const UringQueue&) = delete;
+
+    bool ok() const { return sqes_ != nullptr; }
+
+    /// <summary>
+    ///    :    (READ_FIXED)       .
+    ///  false,    (,  RLIMIT_MEMLOCK).
+    /// </summary>
+    bool registerBuffers(const std::vector<iovec>& buffers) {
+        return syscall(__NR_io_uring_register, ringFd_, IORING_REGISTER_BUFFERS, buffers.data(),
+            static_cast<unsigned>(buffers.size())) == 0;
+    }
+
+    /// <summary>
+    ///      size    offset  buffer.
+    /// bufferIndex >= 0 -   .
+    /// </summary>
+    void queueRead(int fd, char* buffer, unsigned size, uint64_t offset, int bufferIndex, uint64_t userData) {
+        unsigned tail = *sqTail_;
+        unsigned index = tail & sqMask_;
+        io_uring_sqe* sqe = &sqes_[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sqe->opcode = bufferIndex >= 0 ? IORING_OP_READ_FIXED : IORING_OP_READ;
+        sqe->fd = fd;
+        sqe->addr = reinterpret_cast<uint64_t>(buffer);
+        sqe->len = size;
+        sqe->off = offset;
+        sqe->buf_index = static_cast<uint16_t>(std::max(bufferIndex, 0));
+        sqe->user_data = userData;
+        sqArray_[index] = index;
+        //        
+        __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+        ++pending_;
+    }
+
+    /// <summary>
+    ///         waitFor .  false  .
+    /// </summary>
+    bool submit(unsigned waitFor) {
+        while (true) {
+            long submitted = syscall(__NR_io_uring_enter, ringFd_, pending_, waitFor, waitFor ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0);
+            if (submitted >= 0) {
+                pending_ -= static_cast<unsigned>(submitted);
+                return true;
+            }
+            if (errno != EINTR) return false;
+        }
+    }
+
+    /// <summary>
+    ///     ; false -  .
+    /// </summary>
+    bool popCompletion(uint64_t& userData, int& result) {
+        unsigned head = *cqHead_;
+        if (head == __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE)) return false;
+        const io_uring_cqe& cqe = cqes_[head & cqMask_];
+        userData = cqe.user_data;
+        result = cqe.res;
+        __atomic_store_n(cqHead_, head + 1, __ATOMIC_RELEASE);
+        return true;
+    }
+
+private:
+    int ringFd_ = -1;
+    void* sqRing_ = nullptr;
+    void* cqRing_ = nullptr;
+    size_t sqRingSize_ = 0;
+    size_t cqRingSize_ = 0;
+    size_t sqesSize_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    unsigned* sqTail_ = nullptr;
+    unsigned* sqArray_ = nullptr;
+    unsigned sqMask_ = 0;
+    unsigned* cqHead_ = nullptr;
+    unsigned* cqTail_ = nullptr;
+    unsigned cqMask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+    unsigned pending_ = 0;
+};
+
+/// <summary>
+///  size   fd  io_uring: queueDepth      ,
+///    onBlock  ,       .
+///  false,  io_uring      ; ok = false,    .
+/// </summary>
+inline bool uringReadFile(int fd, uint64_t size, const BlockCallback& onBlock, const AsyncReadOptions& options, bool& ok) {
+    ok = true;
+    size_t blockSize = options.blockSize;
+    uint64_t blocks = (size + blockSize - 1) / blockSize;
+    size_t depth = static_cast<size_t>(std::min<uint64_t>(std::max<size_t>(options.queueDepth, 1), blocks));
+
+    //    :          
+    AlignedBuffer arena(depth * blockSize);
+    UringQueue ring(static_cast<unsigned>(depth));
+    if (!ring.ok()) return false;
+
+    std::vector<iovec> buffers(depth);
+    for (size_t slot = 0; slot < depth; ++slot) {
+        buffers[slot].iov_base = arena.data() + slot * blockSize;
+        buffers[slot].iov_len = blockSize;
+    }
+    bool fixed = ring.registerBuffers(buffers);
+
+    //  :  ,       
+    struct Slot {
+        uint64_t block = 0;
+        size_t filled = 0;
+        size_t length = 0;
+        bool done = false;
+    };
+    std::vector<Slot> slots(depth);
+    size_t inFlight = 0;
+
+    auto queueSlot = [&](size_t slot) {
+        Slot& s = slots[slot];
+        ring.queueRead(fd, arena.data() + slot * blockSize + s.filled, static_cast<unsigned>(s.length - s.filled),
+            s.block * blockSize + s.filled, fixed ? static_cast<int>(slot) : -1, slot);
+        ++inFlight;
+    };
+    auto startBlock = [&](size_t slot, uint64_t block) {
+        slots[slot] = Slot{ block, 0, static_cast<size_t>(std::min<uint64_t>(blockSize, size - block * blockSize)), false };
+        queueSlot(slot);
+    };
+    //    ,   
+    auto drain = [&]() {
+        uint64_t userData;
+        int result;
+        while (inFlight > 0 && ring.submit(1)) {
+            while (ring.popCompletion(userData, result)) --inFlight;
+        }
+    };
+
+    try {
+        for (size_t slot = 0; slot < depth; ++slot) startBlock(slot, slot);
+
+        for (uint64_t next = 0; next < blocks && ok;) {
+            size_t slot = static_cast<size_t>(next % depth);
+            if (slots[slot].done) {
+                onBlock(next * blockSize, arena.data() + slot * blockSize, slots[slot].filled);
+                //     :   
+                if (slots[slot].filled < slots[slot].length) break;
+                if (next + depth < blocks) startBlock(slot, next + depth);
+                ++next;
+                continue;
+            }
+
+            if (!ring.submit(1)) {
+                ok = false;
+                break;
+            }
+            uint64_t userData;
+            int result;
+            while (ring.popCompletion(userData, result)) {
+                --inFlight;
+                Slot& s = slots[userData];
+                if (result < 0) {
+                    ok = false;
+                    continue;
+                }
+                s.filled += static_cast<size_t>(result);
+                //       ,    
+                if (result > 0 && s.filled < s.length) queueSlot(static_cast<size_t>(userData));
+                else s.done = true;
+            }
+        }
+    }
+    catch (...) {
+        drain();
+        throw;
+    }
+    drain();
+    return true;
+}
+#endif
+
+/// <summary>
+///   filename    options.blockSize    onBlock  .
+///  Linux  io_uring  options.queueDepth   ,  (  io_uring )
+///    pread,   POSIX -  std::ifstream.
+/// ,    (, /proc),    .
+/// </summary>
+/// <param name="filename"> .</param>
+/// <param name="onBlock"> .</param>
+/// <param name="options">    .</param>
+/// <param name="usedBackend">  nullptr,  ,    .</param>
+/// <returns>true,    ,  false.</returns>
+inline bool readFileAsync(const std::string& filename, const BlockCallback& onBlock, const AsyncReadOptions& options = {},
+    AsyncBackend* usedBackend = nullptr) {
+    AsyncReadOptions opts = options;
+    opts.blockSize = std::max<size_t>(AlignedBuffer::alignment, opts.blockSize / AlignedBuffer::alignment * AlignedBuffer::alignment);
+
+#if ASYNC_IO_HAS_PREAD
+    int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "Error: Cannot open file " << filename << " for reading.\n";
+        return false;
+    }
+    struct stat st {};
+    bool sized = fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0;
+    uint64_t size = sized ? static_cast<uint64_t>(st.st_size) : 0;
+#if defined(POSIX_FADV_SEQUENTIAL)
+    posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    //   (, FIFO,  /proc  /sys  0):  read()   
+    if (!sized) {
+        if (usedBackend) *usedBackend = AsyncBackend::Pread;
+        AlignedBuffer buffer(opts.blockSize);
+        for (uint64_t offset = 0;;) {
+            ssize_t got = read(fd, buffer.data(), opts.blockSize);
+            if (got < 0) {
+                close(fd);
+                std::cerr << "Error: Cannot read file " << filename << ".\n";
+                return false;
+            }
+            if (got == 0) break;
+            onBlock(offset, buffer.data(), static_cast<size_t>(got));
+            offset += static_cast<uint64_t>(got);
+        }
+        close(fd);
+        return true;
+    }
+
+#if ASYNC_IO_HAS_URING
+    if (opts.useUring && size > 0) {
+        bool ok;
+        if (uringReadFile(fd, size, onBlock, opts, ok)) {
+            close(fd);
+            if (usedBackend) *usedBackend = AsyncBackend::Uring;
+            if (!ok) std::cerr << "Error: io_uring read of " << filename << " failed.\n";
+            return ok;
+        }
+    }
+#endif
+
+    //     
+    if (usedBackend) *usedBackend = AsyncBackend::Pread;
+    AlignedBuffer buffer(opts.blockSize);
+    for (uint64_t offset = 0; offset < size;) {
+        ssize_t got = pread(fd, buffer.data(), static_cast<size_t>(std::min<uint64_t>(opts.blockSize, size - offset)),
+            static_cast<off_t>(offset));
+        if (got < 0) {
+            close(fd);
+            std::cerr << "Error: Cannot read file " << filename << ".\n";
+            return false;
+        }
+        if (got == 0) break;
+        onBlock(offset, buffer.data(), static_cast<size_t>(got));
+        offset += static_cast<uint64_t>(got);
+    }
+    close(fd);
+    return true;
+#else
+    std::ifstream ifs(filename, std::ios::binary);
+    if (!ifs.is_open()) {
+        std::cerr << "Error: Cannot open file " << filename << " for reading.\n";
+        return false;
+    }
+    if (usedBackend) *usedBackend = AsyncBackend::Stream;
+    AlignedBuffer buffer(opts.blockSize);
+    for (uint64_t offset = 0;;) {
+        ifs.read(buffer.data(), static_cast<std::streamsize>(opts.blockSize));
+        size_t got = static_cast<size_t>(ifs.gcount());
+        if (got == 0) break;
+        onBlock(offset, buffer.data(), got);
+        offset += got;
+    }
+    return !ifs.bad();
+#endif
+}
+
+/// <summary>
+///     -1,    .
+/// </summary>
+inline int64_t fileSize(const std::string& filename) {
+    std::ifstream ifs(filename, std::ios::binary | std::ios::ate);
+    if (!ifs.is_open()) return -1;
+    return static_cast<int64_t>(ifs.tellg());
+}
+
+/// <summary>
+///       readFileAsync.
+/// </summary>
+/// <returns>true,    ,  false.</returns>
+inline bool readWholeFileAsync(const std::string& filename, std::vector<char>& data, const AsyncReadOptions& options = {}) {
+    int64_t size = fileSize(filename);
+    if (size < 0) {
+        std::cerr << "Error: Cannot open file " << filename << " for reading.\n";
+        return false;
+    }
+    data.resize(static_cast<size_t>(size));
+    size_t received = 0;
+    bool ok = readFileAsync(filename, [&](uint64_t offset, const char* block, size_t blockSize) {
+        //      
+        if (offset >= data.size()) return;
+        size_t n = std::min<size_t>(blockSize, data.size() - static_cast<size_t>(offset));
+        std::memcpy(data.data() + offset, block, n);
+        received = static_cast<size_t>(offset) + n;
+    }, options);
+    data.resize(received);
+    return ok;
+}
@@ -0,0 +1,107 @@
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "lib.h"
+
+/// <summary>
+///     ,      .
+/// </summary>
+void dropFileCache(const std::string& filename) {
+#if ASYNC_IO_HAS_PREAD && defined(POSIX_FADV_DONTNEED)
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    fdatasync(fd);
+    posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+    close(fd);
+#else
+    (void)filename;
+#endif
+}
+
+/// <summary>
+///    ,  readArrayMsgpack: std::ifstream   1 ,    read.
+/// </summary>
+size_t readWithStream(const std::string& filename) {
+    std::ifstream ifs(filename, std::ios::binary);
+    std::vector<char> buffer(1048576);
+    ifs.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+    ifs.seekg(0, std::ios::end);
+    size_t size = ifs.tellg();
+    ifs.seekg(0, std::ios::beg);
+    std::vector<char> data(size);
+    ifs.read(data.data(), size);
+    return static_cast<size_t>(ifs.gcount());
+}
+
+int main() {
+    size_t sizeMb;
+
+    //    
+    std::cout << "Enter the test file size in MB: ";
+    if (!(std::cin >> sizeMb) || sizeMb == 0) {
+        std::cerr << "Error: Invalid file size.\n";
+        return 1;
+    }
+
+    //     
+    const std::string filename = "async_io_bench.bin";
+    {
+        std::ofstream ofs(filename, std::ios::binary);
+        std::mt19937_64 gen(42);
+        std::vector<uint64_t> block(1 << 17);
+        for (size_t written = 0; written < (sizeMb << 20); written += block.size() * sizeof(uint64_t)) {
+            for (auto& value : block) value = gen();
+            ofs.write(reinterpret_cast<const char*>(block.data()), block.size() * sizeof(uint64_t));
+        }
+    }
+
+    //        ,  /
+    auto measure = [&](bool cold, auto read) {
+        if (cold) dropFileCache(filename);
+        auto start = std::chrono::high_resolution_clock::now();
+        size_t bytes = read();
+        auto end = std::chrono::high_resolution_clock::now();
+        return bytes / 1048576.0 / std::chrono::duration<double>(end - start).count();
+    };
+
+    std::cout << "method\tblock KB\tdepth\tcold MB/s\twarm MB/s\n";
+
+    double streamCold = measure(true, [&]() { return readWithStream(filename); });
+    double streamWarm = measure(false, [&]() { return readWithStream(filename); });
+    std::cout << "ifstream\t-\t-\t" << streamCold << "\t" << streamWarm << "\n";
+
+    for (size_t blockKb : { size_t(128), size_t(1024) }) {
+        for (size_t depth : { size_t(1), size_t(4), size_t(16), size_t(64) }) {
+            AsyncReadOptions options;
+            options.blockSize = blockKb << 10;
+            options.queueDepth = depth;
+            AsyncBackend backend = AsyncBackend::Stream;
+            auto read = [&]() {
+                size_t bytes = 0;
+                readFileAsync(filename, [&](uint64_t, const char*, size_t size) { bytes += size; }, options, &backend);
+                return bytes;
+            };
+            double cold = measure(true, read);
+            double warm = measure(false, read);
+            std::cout << backendName(backend) << "\t" << blockKb << "\t" << depth << "\t" << cold << "\t" << warm << "\n";
+        }
+        AsyncReadOptions options;
+        options.blockSize = blockKb << 10;
+        options.useUring = false;
+        auto read = [&]() {
+            size_t bytes = 0;
+            readFileAsync(filename, [&](uint64_t, const char*, size_t size) { bytes += size; }, options);
+            return bytes;
+        };
+        double cold = measure(true, read);
+        double warm = measure(false, read);
+        std::cout << "pread\t" << blockKb << "\t1\t" << cold << "\t" << warm << "\n";
+    }
+
+    std::remove(filename.c_str());
+    std::cout << "All benchmarks completed successfully.\n";
+    return 0;
+}
@@ -0,0 +1,5 @@
+//
+// pch.cpp
+//
+
+#include "pch.h"
@@ -0,0 +1,11 @@
+//
+// pch.h
+//
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include "lib.h"
@@ -0,0 +1,123 @@
+#include "pch.h"
+
+#include <random>
+#include <thread>
+
+//    size      
+std::vector<char> makeTestFile(const std::string& filename, size_t size) {
+    std::vector<char> data(size);
+    std::mt19937 gen(static_cast<unsigned>(size));
+    for (auto& c : data) c = static_cast<char>(gen());
+    std::ofstream ofs(filename, std::ios::binary);
+    ofs.write(data.data(), data.size());
+    return data;
+}
+
+//   readFileAsync      
+void expectReadsFile(const std::vector<char>& expected, const std::string& filename, const AsyncReadOptions& options) {
+    std::vector<char> received;
+    bool ordered = true;
+    bool ok = readFileAsync(filename, [&](uint64_t offset, const char* data, size_t size) {
+        ordered = ordered && offset == received.size() && size <= options.blockSize + AlignedBuffer::alignment;
+        received.insert(received.end(), data, data + size);
+    }, options);
+    EXPECT_TRUE(ok) << "Read failed";
+    EXPECT_TRUE(ordered) << "Blocks are not delivered in file order";
+    EXPECT_TRUE(received == expected) << "Read data differs from file, size " << expected.size()
+        << ", block " << options.blockSize << ", depth " << options.queueDepth;
+}
+
+//         
+TEST(AsyncReadTest, MatchesFileContents) {
+    const std::string filename = "async_test.bin";
+    for (size_t size : { size_t(0), size_t(1), size_t(4095), size_t(4096), size_t(100000), size_t(3 << 20) }) {
+        auto expected = makeTestFile(filename, size);
+        for (size_t depth : { size_t(1), size_t(3), size_t(16) }) {
+            AsyncReadOptions options;
+            options.blockSize = 8192;
+            options.queueDepth = depth;
+            expectReadsFile(expected, filename, options);
+        }
+        AsyncReadOptions blocking;
+        blocking.useUring = false;
+        expectReadsFile(expected, filename, blocking);
+    }
+    std::remove(filename.c_str());
+}
+
+//    :  Linux  io_uring    
+TEST(AsyncReadTest, ReportsBackend) {
+    const std::string filename = "async_backend.bin";
+    makeTestFile(filename, 50000);
+    AsyncBackend backend = AsyncBackend::Stream;
+    AsyncReadOptions options;
+    options.useUring = false;
+    EXPECT_TRUE(readFileAsync(filename, [](uint64_t, const char*, size_t) {}, options, &backend));
+#if ASYNC_IO_HAS_PREAD
+    EXPECT_EQ(backend, AsyncBackend::Pread);
+#endif
+#if ASYNC_IO_HAS_URING
+    UringQueue probe(4);
+    options.useUring = true;
+    EXPECT_TRUE(readFileAsync(filename, [](uint64_t, const char*, size_t) {}, options, &backend));
+    EXPECT_EQ(backend, probe.ok() ? AsyncBackend::Uring : AsyncBackend::Pread);
+#endif
+    std::remove(filename.c_str());
+}
+
+//       
+TEST(AsyncReadTest, WholeFileAndMissingFile) {
+    const std::string filename = "async_whole.bin";
+    auto expected = makeTestFile(filename, 1234567);
+    std::vector<char> data;
+    EXPECT_TRUE(readWholeFileAsync(filename, data));
+    EXPECT_TRUE(data == expected) << "Whole file read differs from file";
+    std::remove(filename.c_str());
+    EXPECT_FALSE(readWholeFileAsync("async_missing.bin", data)) << "Missing file must not be read";
+}
+
+//    :    
+TEST(AsyncReadTest, CallbackExceptionStopsReading) {
+    const std::string filename = "async_throw.bin";
+    makeTestFile(filename, 1 << 20);
+    AsyncReadOptions options;
+    options.blockSize = 4096;
+    options.queueDepth = 32;
+    size_t calls = 0;
+    EXPECT_THROW(readFileAsync(filename, [&](uint64_t, const char*, size_t) {
+        if (++calls == 3) throw std::runtime_error("stop");
+    }, options), std::runtime_error);
+    EXPECT_EQ(calls, size_t(3));
+    std::remove(filename.c_str());
+}
+
+#if ASYNC_IO_HAS_PREAD
+//     :  FIFO   /proc   ,      fstat
+TEST(AsyncReadTest, ReadsFilesWithoutSize) {
+    const std::string filename = "async_fifo";
+    std::remove(filename.c_str());
+    ASSERT_EQ(mkfifo(filename.c_str(), 0600), 0);
+    std::vector<char> expected(100000);
+    for (size_t i = 0; i < expected.size(); ++i) expected[i] = static_cast<char>(i * 7);
+    std::thread writer([&]() {
+        std::ofstream ofs(filename, std::ios::binary);
+        ofs.write(expected.data(), expected.size());
+    });
+    std::vector<char> received;
+    EXPECT_TRUE(readFileAsync(filename, [&](uint64_t offset, const char* data, size_t size) {
+        EXPECT_EQ(offset, received.size());
+        received.insert(received.end(), data, data + size);
+    }));
+    writer.join();
+    EXPECT_TRUE(received == expected) << "FIFO read differs from written data";
+    std::remove(filename.c_str());
+
+#if defined(__linux__)
+    std::string status;
+    EXPECT_TRUE(readFileAsync("/proc/self/status", [&](uint64_t, const char* data, size_t size) {
+        status.append(data, size);
+    }));
+    EXPECT_NE(status.find("Name:"), std::string::npos) << "/proc file must not come back empty";
+#endif
+}
+#endif
@@ -2,16 +2,27 @@
 #include <vector>
 #include <string>
 #include "lib.h"
+#include "../sort_policy/autotune.h"
 
 int main() {
+    //  ,  sort_policy --calibrate,    
+    if (loadSortProfileAtStartup()) {
+        std::cout << "Loaded sort profile " << defaultSortProfileFile << "\n";
+    }
+
     size_t numThreads;
 
-    //   
-    std::cout << "Enter the number of threads (max 16): ";
-    if (!(std::cin >> numThreads) || numThreads == 0 || numThreads > 16) {
-        std::cerr << "Error: Invalid number of threads. Must be between 1 and 16.\n";
+    //   ;      
+    std::cout << "Enter the number of threads (max " << sortTuning.maxThreads << ", Enter - from sort profile): ";
+    if (!readThreadCount(std::cin, numThreads)) {
+        std::cerr << "Error: Invalid number of threads. Must be between 1 and " << sortTuning.maxThreads << ".\n";
         return 1;
     }
+    if (numThreads == 0) {
+        //         
+        compareAutoSort();
+        numThreads = sortTuning.maxThreads;
+    }
 
     //   
     testSortPerformance(numThreads);
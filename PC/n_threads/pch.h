@@ -5,3 +5,4 @@
 #include <string>
 #include <filesystem>
 #include "lib.h" //     
+#include "sorted_store.h"
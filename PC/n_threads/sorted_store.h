@@ -0,0 +1,381 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include <cstdint>
+#include "lib.h"
+
+/// <summary>
+///         merge.
+///     ,     ,
+///       .
+/// </summary>
+/// <typeparam name="T">   (int, float)</typeparam>
+/// <param name="runs">   .</param>
+/// <param name="numThreads">      .</param>
+/// <returns> ,    .</returns>
+template <typename T>
+std::vector<T> mergeRuns(const std::vector<std::shared_ptr<const std::vector<T>>>& runs, size_t numThreads) {
+    //  :  i  [bounds[i], bounds[i + 1])
+    std::vector<size_t> bounds = { 0 };
+    size_t total = 0;
+    for (const auto& run : runs) {
+        total += run->size();
+        bounds.push_back(total);
+    }
+
+    //     
+    std::vector<T> arr(total);
+    for (size_t i = 0; i < runs.size(); ++i) {
+        if (!runs[i]->empty()) {
+            std::memcpy(arr.data() + bounds[i], runs[i]->data(), runs[i]->size() * sizeof(T));
+        }
+    }
+
+    std::vector<T> temp(total);
+    //    ,    
+    while (bounds.size() > 2) {
+        std::vector<size_t> nextBounds = { 0 };
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i + 1 < bounds.size(); i += 2) {
+            size_t left = bounds[i];
+            if (i + 2 < bounds.size()) {
+                size_t mid = bounds[i + 1];
+                size_t right = bounds[i + 2];
+                //   ,   temp 
+                if (mid > left && right > mid) {
+                    if (threads.size() + 1 < numThreads) {
+                        threads.emplace_back(merge<T>, std::ref(arr), left, mid - 1, right - 1, std::ref(temp));
+                    }
+                    else {
+                        merge(arr, left, mid - 1, right - 1, temp);
+                    }
+                }
+                nextBounds.push_back(right);
+            }
+            else {
+                //         
+                nextBounds.push_back(bounds[i + 1]);
+            }
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        bounds = std::move(nextBounds);
+    }
+    return arr;
+}
+
+/// <summary>
+///     LSM-.
+///         0;  
+///   fanout       .
+///      :  
+///   ,      
+/// (epoch-based reclamation),        .
+/// </summary>
+/// <typeparam name="T">   (int, float)</typeparam>
+template <typename T>
+class SortedStore {
+    using Run = std::shared_ptr<const std::vector<T>>;
+
+    /// <summary>
+    ///   ,  .
+    /// </summary>
+    struct State {
+        std::vector<Run> runs; //    
+        size_t size = 0;       //   
+    };
+
+    /// <summary>
+    /// ,     .
+    /// </summary>
+    struct Retired {
+        const State* state;
+        uint64_t epoch; // ,       
+    };
+
+public:
+    ///     
+    static constexpr size_t maxReaders = 64;
+
+    /// <summary>
+    ///   .   ,    .
+    /// </summary>
+    class Snapshot {
+    public:
+        Snapshot(Snapshot&& other) noexcept : store_(other.store_), state_(other.state_), slot_(other.slot_) {
+            other.store_ = nullptr;
+        }
+        Snapshot(const Snapshot&) = delete;
+        Snapshot& operator=(const Snapshot&) = delete;
+        Snapshot& operator=(Snapshot&&) = delete;
+
+        ~Snapshot() {
+            if (store_) {
+                //   ,    
+                store_->readerEpochs_[slot_].store(0);
+            }
+        }
+
+        /// <summary>
+        ///     .
+        /// </summary>
+        size_t size() const {
+            return state_->size;
+        }
+
+        /// <summary>
+        ///      .
+        /// </summary>
+        size_t runCount() const {
+            return state_->runs.size();
+        }
+
+        /// <summary>
+        ///        .
+        /// </summary>
+        /// <param name="key"> .</param>
+        /// <returns>true,   ,  false.</returns>
+        bool contains(const T& key) const {
+            for (const auto& run : state_->runs) {
+                if (std::binary_search(run->begin(), run->end(), key)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        /// <summary>
+        ///   ,  key.
+        /// </summary>
+        size_t count(const T& key) const {
+            size_t result = 0;
+            for (const auto& run : state_->runs) {
+                auto range = std::equal_range(run->begin(), run->end(), key);
+                result += static_cast<size_t>(range.second - range.first);
+            }
+            return result;
+        }
+
+        /// <summary>
+        ///   ,   key ( ).
+        /// </summary>
+        size_t rank(const T& key) const {
+            size_t result = 0;
+            for (const auto& run : state_->runs) {
+                result += static_cast<size_t>(std::lower_bound(run->begin(), run->end(), key) - run->begin());
+            }
+            return result;
+        }
+
+        /// <summary>
+        ///        .
+        /// </summary>
+        std::vector<T> toVector() const {
+            return mergeRuns(state_->runs, 1);
+        }
+
+    private:
+        friend class SortedStore;
+        Snapshot(const SortedStore* store, const State* state, size_t slot) : store_(store), state_(state), slot_(slot) {}
+
+        const SortedStore* store_;
+        const State* state_;
+        size_t slot_;
+    };
+
+    /// <summary>
+    ///        .
+    /// </summary>
+    /// <param name="numThreads">      .</param>
+    /// <param name="fanout">  ,       .</param>
+    explicit SortedStore(size_t numThreads = 1, size_t fanout = 4)
+        : numThreads_(std::max<size_t>(numThreads, 1)), fanout_(std::max<size_t>(fanout, 2)) {
+        for (auto& epoch : readerEpochs_) {
+            epoch.store(0);
+        }
+        current_.store(new State());
+        merger_ = std::thread(&SortedStore::mergeLoop, this);
+    }
+
+    SortedStore(const SortedStore&) = delete;
+    SortedStore& operator=(const SortedStore&) = delete;
+
+    /// <summary>
+    ///       .
+    ///        .
+    /// </summary>
+    ~SortedStore() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wakeMerger_.notify_all();
+        merger_.join();
+        for (const auto& retired : retired_) {
+            delete retired.state;
+        }
+        delete current_.load();
+    }
+
+    /// <summary>
+    ///           0.
+    ///      .
+    /// </summary>
+    /// <param name="batch">    .</param>
+    void insertBatch(std::vector<T> batch) {
+        if (batch.empty()) return; //     
+        //    
+        singleThreadMergeSort(batch);
+        Run run = std::make_shared<const std::vector<T>>(std::move(batch));
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (levels_.empty()) {
+                levels_.emplace_back();
+            }
+            levels_[0].push_back(std::move(run));
+            publishLocked();
+        }
+        wakeMerger_.notify_all();
+    }
+
+    /// <summary>
+    ///    .    .
+    /// </summary>
+    Snapshot snapshot() const {
+        size_t slot = 0;
+        //    ,     
+        for (;; slot = (slot + 1) % maxReaders) {
+            uint64_t expected = 0;
+            uint64_t epoch = globalEpoch_.load();
+            if (readerEpochs_[slot].compare_exchange_strong(expected, epoch)) {
+                break;
+            }
+            if (slot + 1 == maxReaders) {
+                std::this_thread::yield(); //   
+            }
+        }
+        //     ,     
+        return Snapshot(this, current_.load(), slot);
+    }
+
+    /// <summary>
+    /// ,        .
+    /// </summary>
+    void flush() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_.wait(lock, [this] { return !merging_ && findFullLevelLocked() == levels_.size(); });
+    }
+
+    /// <summary>
+    ///    .
+    /// </summary>
+    size_t levelCount() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return levels_.size();
+    }
+
+private:
+    /// <summary>
+    ///    ,    fanout ,  levels_.size().
+    /// </summary>
+    size_t findFullLevelLocked() const {
+        for (size_t i = 0; i < levels_.size(); ++i) {
+            if (levels_[i].size() >= fanout_) {
+                return i;
+            }
+        }
+        return levels_.size();
+    }
+
+    /// <summary>
+    ///          ,
+    ///       .   mutex_.
+    /// </summary>
+    void publishLocked() {
+        State* next = new State();
+        //      ,   
+        for (size_t i = levels_.size(); i-- > 0;) {
+            for (const auto& run : levels_[i]) {
+                next->runs.push_back(run);
+                next->size += run->size();
+            }
+        }
+        const State* previous = current_.exchange(next);
+        // ,     ,    
+        uint64_t epoch = globalEpoch_.fetch_add(1) + 1;
+        retired_.push_back({ previous, epoch });
+
+        //     
+        uint64_t minEpoch = UINT64_MAX;
+        for (const auto& readerEpoch : readerEpochs_) {
+            uint64_t value = readerEpoch.load();
+            if (value != 0) {
+                minEpoch = std::min(minEpoch, value);
+            }
+        }
+        //  ,     
+        auto it = std::remove_if(retired_.begin(), retired_.end(), [minEpoch](const Retired& retired) {
+            if (retired.epoch <= minEpoch) {
+                delete retired.state;
+                return true;
+            }
+            return false;
+        });
+        retired_.erase(it, retired_.end());
+    }
+
+    /// <summary>
+    ///   :   ,    .
+    /// </summary>
+    void mergeLoop() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        for (;;) {
+            wakeMerger_.wait(lock, [this] { return stop_ || findFullLevelLocked() < levels_.size(); });
+            if (stop_) return;
+
+            size_t level = findFullLevelLocked();
+            //    ,   
+            std::vector<Run> inputs(levels_[level].begin(), levels_[level].begin() + fanout_);
+            merging_ = true;
+            lock.unlock();
+
+            Run merged = std::make_shared<const std::vector<T>>(mergeRuns(inputs, numThreads_));
+
+            lock.lock();
+            //        
+            auto& runs = levels_[level];
+            runs.erase(std::remove_if(runs.begin(), runs.end(), [&inputs](const Run& run) {
+                return std::find(inputs.begin(), inputs.end(), run) != inputs.end();
+            }), runs.end());
+            if (level + 1 == levels_.size()) {
+                levels_.emplace_back();
+            }
+            levels_[level + 1].push_back(std::move(merged));
+            publishLocked();
+            merging_ = false;
+            idle_.notify_all();
+        }
+    }
+
+    const size_t numThreads_;
+    const size_t fanout_;
+
+    mutable std::mutex mutex_;              //      
+    std::condition_variable wakeMerger_;    //       
+    std::condition_variable idle_;          //    
+    std::vector<std::vector<Run>> levels_;  //   
+    std::vector<Retired> retired_;          // ,  
+    bool merging_ = false;
+    bool stop_ = false;
+
+    std::atomic<const State*> current_{ nullptr };          //   
+    std::atomic<uint64_t> globalEpoch_{ 1 };                //  
+    mutable std::atomic<uint64_t> readerEpochs_[maxReaders]; //    (0 -  )
+    std::thread merger_;
+};
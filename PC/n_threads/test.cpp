@@ -3,4 +3,58 @@
 TEST(TestCaseName, TestName) {
   EXPECT_EQ(1, 1);
   EXPECT_TRUE(true);
-}
\ No newline at end of file
+}
+
+//     
+TEST(SortedStoreTest, BatchesMatchFullSort) {
+    SortedStore<int> store(2, 4);
+    std::vector<int> all;
+    for (int i = 0; i < 37; ++i) {
+        std::vector<int> batch = generateRandomArray<int>(1000 + i);
+        all.insert(all.end(), batch.begin(), batch.end());
+        store.insertBatch(batch);
+    }
+    store.flush();
+    std::sort(all.begin(), all.end());
+
+    auto snap = store.snapshot();
+    EXPECT_EQ(snap.size(), all.size()) << "Store size does not match inserted elements";
+    EXPECT_LT(snap.runCount(), size_t(37)) << "Background merges did not reduce run count";
+    EXPECT_EQ(snap.toVector(), all) << "Store contents do not match std::sort";
+    EXPECT_EQ(snap.count(0), size_t(std::count(all.begin(), all.end(), 0)));
+    EXPECT_EQ(snap.rank(0), size_t(std::lower_bound(all.begin(), all.end(), 0) - all.begin()));
+    EXPECT_FALSE(snap.contains(1000)) << "Value out of generated range found";
+}
+
+//      
+TEST(SortedStoreTest, SnapshotsStayConsistentDuringMerges) {
+    SortedStore<int> store(2, 2);
+    std::atomic<bool> done{ false };
+    std::atomic<bool> consistent{ true };
+
+    std::thread reader([&] {
+        size_t lastSize = 0;
+        while (!done.load()) {
+            auto snap = store.snapshot();
+            //    ,   7    
+            if (snap.size() < lastSize || (snap.size() > 0 && !snap.contains(7))) {
+                consistent = false;
+            }
+            lastSize = snap.size();
+        }
+    });
+
+    for (int i = 0; i < 200; ++i) {
+        std::vector<int> batch = generateRandomArray<int>(500);
+        batch[0] = 7;
+        store.insertBatch(batch);
+    }
+    store.flush();
+    done = true;
+    reader.join();
+
+    EXPECT_TRUE(consistent.load()) << "Reader observed an inconsistent snapshot";
+    auto snap = store.snapshot();
+    EXPECT_EQ(snap.size(), size_t(200 * 500));
+    EXPECT_TRUE(isSorted(snap.toVector()));
+}
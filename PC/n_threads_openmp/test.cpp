@@ -148,4 +148,33 @@ TEST(ParallelSortTest, RepeatedElements) {
     EXPECT_TRUE(isSorted(arr)) << "Repeated elements array is not sorted";
     std::sort(original.begin(), original.end());
     EXPECT_EQ(arr, original) << "Repeated elements array does not match std::sort";
-}
\ No newline at end of file
+}
+//        
+TEST(TaskParallelSortTest, CutoffDepths) {
+    for (size_t cutoff : { size_t(0), size_t(1), size_t(4), size_t(12) }) {
+        std::vector<int> arr = generateRandomArray<int>(1000003);
+        auto original = arr;
+        taskParallelMergeSort(arr, 4, cutoff);
+        EXPECT_TRUE(isSorted(arr)) << "Array is not sorted with cutoff " << cutoff;
+        std::sort(original.begin(), original.end());
+        EXPECT_EQ(arr, original) << "Task sort does not match std::sort with cutoff " << cutoff;
+    }
+}
+
+TEST(TaskParallelSortTest, FloatAndEdgeCases) {
+    std::vector<float> arr = generateRandomArray<float>(300000);
+    auto original = arr;
+    taskParallelMergeSort(arr, 3);
+    std::sort(original.begin(), original.end());
+    EXPECT_EQ(arr, original) << "Float task sort does not match std::sort";
+
+    std::vector<int> empty;
+    taskParallelMergeSort(empty, 4);
+    EXPECT_TRUE(empty.empty()) << "Empty array modified unexpectedly";
+
+    std::vector<int> repeated(100000, 42);
+    std::fill(repeated.begin(), repeated.begin() + 50000, -42);
+    std::reverse(repeated.begin(), repeated.end());
+    taskParallelMergeSort(repeated, 4);
+    EXPECT_TRUE(isSorted(repeated)) << "Repeated elements array is not sorted";
+}
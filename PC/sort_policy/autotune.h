@@ -0,0 +1,387 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include "lib.h"
+#include "sort_algorithms.h"
+
+///  ,    
+inline const std::string defaultSortProfileFile = "sort_profile.txt";
+
+///  ,        
+inline const std::vector<size_t> calibrationSizes = { 10000, 100000, 1000000, 10000000 };
+
+/// <summary>
+///  ,  .
+/// </summary>
+enum class SortAlgorithm {
+    Merge,  // policyMergeSort
+    Radix,  // radixSort
+    Sample  // sampleSort
+};
+
+/// <summary>
+///   ,      .
+/// </summary>
+inline const char* algorithmName(SortAlgorithm algorithm) {
+    switch (algorithm) {
+    case SortAlgorithm::Radix: return "radix";
+    case SortAlgorithm::Sample: return "sample";
+    default: return "merge";
+    }
+}
+
+/// <summary>
+///      .
+/// </summary>
+/// <returns>false,   .</returns>
+inline bool parseAlgorithm(const std::string& name, SortAlgorithm& algorithm) {
+    for (SortAlgorithm candidate : { SortAlgorithm::Merge, SortAlgorithm::Radix, SortAlgorithm::Sample }) {
+        if (name == algorithmName(candidate)) {
+            algorithm = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/// <summary>
+///    :     maxSize   algorithm  threads .
+/// </summary>
+struct SizeClassTuning {
+    size_t maxSize = 0;
+    size_t threads = 1;
+    SortAlgorithm algorithm = SortAlgorithm::Merge;
+};
+
+/// <summary>
+///  :         .
+/// </summary>
+struct SortProfile {
+    SortTuning tuning;
+    std::vector<SizeClassTuning> classes; //   maxSize
+};
+
+/// <summary>
+///  ,   autoSort  .
+/// </summary>
+inline SortProfile& activeSortProfile() {
+    static SortProfile profile;
+    return profile;
+}
+
+/// <summary>
+///   :   sortTuning    .
+/// </summary>
+inline void applySortProfile(const SortProfile& profile) {
+    activeSortProfile() = profile;
+    sortTuning = profile.tuning;
+}
+
+/// <summary>
+///     :     ,
+///  "class <maxSize> <threads> <algorithm>"    .
+/// </summary>
+/// <returns>true,   .</returns>
+inline bool saveSortProfile(const SortProfile& profile, const std::string& filename) {
+    std::ofstream ofs(filename);
+    if (!ofs.is_open()) {
+        std::cerr << "Error: Cannot open file " << filename << " for writing.\n";
+        return false;
+    }
+    ofs << "maxThreads " << profile.tuning.maxThreads << "\n";
+    ofs << "mergeGrain " << profile.tuning.mergeGrain << "\n";
+    ofs << "ioBufferSize " << profile.tuning.ioBufferSize << "\n";
+    for (const SizeClassTuning& sizeClass : profile.classes) {
+        ofs << "class " << sizeClass.maxSize << " " << sizeClass.threads << " " << algorithmName(sizeClass.algorithm) << "\n";
+    }
+    return static_cast<bool>(ofs);
+}
+
+/// <summary>
+///       ; ,     .
+/// </summary>
+inline bool readProfileValue(std::istream& fields, size_t& value) {
+    std::string token;
+    if (!(fields >> token) || token.empty() || token.size() > 19) return false;
+    if (!std::all_of(token.begin(), token.end(), [](char c) { return c >= '0' && c <= '9'; })) return false;
+    value = static_cast<size_t>(std::stoull(token));
+    return value > 0;
+}
+
+/// <summary>
+///    ,  saveSortProfile.
+///      ,    .
+/// </summary>
+/// <returns>false,        ; profile     .</returns>
+inline bool loadSortProfile(SortProfile& profile, const std::string& filename) {
+    std::ifstream ifs(filename);
+    if (!ifs.is_open()) return false;
+    SortProfile loaded;
+    std::string line;
+    while (std::getline(ifs, line)) {
+        std::istringstream fields(line);
+        std::string key;
+        if (!(fields >> key)) continue; //   
+        bool valid = true;
+        if (key == "maxThreads") valid = readProfileValue(fields, loaded.tuning.maxThreads);
+        else if (key == "mergeGrain") valid = readProfileValue(fields, loaded.tuning.mergeGrain);
+        else if (key == "ioBufferSize") valid = readProfileValue(fields, loaded.tuning.ioBufferSize);
+        else if (key == "class") {
+            SizeClassTuning sizeClass;
+            std::string name;
+            valid = readProfileValue(fields, sizeClass.maxSize) && readProfileValue(fields, sizeClass.threads)
+                && static_cast<bool>(fields >> name) && parseAlgorithm(name, sizeClass.algorithm);
+            loaded.classes.push_back(sizeClass);
+        }
+        else valid = false;
+        std::string extra;
+        valid = valid && !(fields >> extra); //    
+        if (!valid) {
+            std::cerr << "Error: Invalid line in sort profile " << filename << ": " << line << "\n";
+            return false;
+        }
+    }
+    std::sort(loaded.classes.begin(), loaded.classes.end(),
+        [](const SizeClassTuning& a, const SizeClassTuning& b) { return a.maxSize < b.maxSize; });
+    profile = loaded;
+    return true;
+}
+
+/// <summary>
+///        .
+/// </summary>
+/// <returns>false,    ;    .</returns>
+inline bool loadSortProfileAtStartup(const std::string& filename = defaultSortProfileFile) {
+    SortProfile profile;
+    if (!loadSortProfile(profile, filename)) return false;
+    applySortProfile(profile);
+    return true;
+}
+
+/// <summary>
+///    .
+/// </summary>
+template <typename Policy, typename T>
+void sortWith(SortAlgorithm algorithm, std::vector<T>& arr, size_t numThreads) {
+    switch (algorithm) {
+    case SortAlgorithm::Radix: radixSort<Policy>(arr, numThreads); break;
+    case SortAlgorithm::Sample: sampleSort<Policy>(arr, numThreads); break;
+    default: policyMergeSort<Policy>(arr, numThreads); break;
+    }
+}
+
+/// <summary>
+///     ,        size.
+///   -      .
+/// </summary>
+inline SizeClassTuning chooseSortClass(size_t size) {
+    const std::vector<SizeClassTuning>& classes = activeSortProfile().classes;
+    if (classes.empty()) {
+        SizeClassTuning fallback;
+        fallback.maxSize = size;
+        fallback.threads = std::max(1u, std::thread::hardware_concurrency());
+        return fallback;
+    }
+    //  ,  ;    - 
+    auto it = std::find_if(classes.begin(), classes.end(),
+        [&](const SizeClassTuning& sizeClass) { return size <= sizeClass.maxSize; });
+    return it == classes.end() ? classes.back() : *it;
+}
+
+/// <summary>
+///      ,   
+///    .   -      .
+/// </summary>
+/// <typeparam name="T">   (int, float)</typeparam>
+/// <param name="arr">  .</param>
+template <typename T>
+void autoSort(std::vector<T>& arr) {
+    SizeClassTuning chosen = chooseSortClass(arr.size());
+    sortWith<ThreadPolicy>(chosen.algorithm, arr, chosen.threads);
+}
+
+/// <summary>
+///      .      .
+/// </summary>
+/// <param name="numThreads"> ; 0 -  .</param>
+/// <returns>false,        sortTuning.maxThreads.</returns>
+inline bool readThreadCount(std::istream& in, size_t& numThreads) {
+    std::string line;
+    if (!std::getline(in, line)) return false;
+    std::istringstream fields(line);
+    std::string rest;
+    if (!(fields >> rest)) {
+        numThreads = 0;
+        return true;
+    }
+    fields.clear();
+    fields.seekg(0);
+    if (!readProfileValue(fields, numThreads) || fields >> rest) return false;
+    return numThreads <= sortTuning.maxThreads;
+}
+
+/// <summary>
+///     sizes  autoSort  
+///          .
+/// </summary>
+inline void compareAutoSort(const std::vector<size_t>& sizes = performanceSizes) {
+    for (size_t size : sizes) {
+        SizeClassTuning chosen = chooseSortClass(size);
+        std::vector<int> arr = generateRandomArray<int, ThreadPolicy>(size, chosen.threads);
+        auto start = std::chrono::high_resolution_clock::now();
+        autoSort(arr);
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << "Array size: " << size << ", Auto sort: " << algorithmName(chosen.algorithm)
+            << ", Threads: " << chosen.threads << ": "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms"
+            << (std::is_sorted(arr.begin(), arr.end()) ? "" : " WRONG RESULT") << "\n";
+    }
+}
+
+/// <summary>
+///      input   .
+/// </summary>
+/// <returns>  .</returns>
+inline long long timeSort(const std::vector<int>& input, SortAlgorithm algorithm, size_t numThreads, size_t repeats) {
+    long long best = -1;
+    for (size_t r = 0; r < repeats; ++r) {
+        std::vector<int> arr = input;
+        auto start = std::chrono::high_resolution_clock::now();
+        sortWith<ThreadPolicy>(algorithm, arr, numThreads);
+        auto end = std::chrono::high_resolution_clock::now();
+        long long elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start).count();
+        if (best < 0 || elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+/// <summary>
+///     -:     
+///        .
+/// </summary>
+/// <param name="fileBytes">  .</param>
+/// <returns>  .</returns>
+inline size_t calibrateIoBufferSize(size_t fileBytes = 64 << 20) {
+    std::string filename = (std::filesystem::temp_directory_path() / "sort_profile_io.tmp").string();
+    std::vector<char> data(fileBytes, 'x');
+    size_t bestSize = defaultIoBufferSize;
+    long long bestTime = -1;
+    for (size_t bufferSize : { size_t(64) << 10, size_t(256) << 10, size_t(1) << 20, size_t(4) << 20 }) {
+        std::vector<char> buffer(bufferSize);
+        auto start = std::chrono::high_resolution_clock::now();
+        {
+            std::ofstream ofs(filename, std::ios::binary);
+            ofs.rdbuf()->pubsetbuf(buffer.data(), bufferSize);
+            //    4 ,     
+            for (size_t offset = 0; offset < fileBytes; offset += 4096) {
+                ofs.write(data.data() + offset, std::min<size_t>(4096, fileBytes - offset));
+            }
+        }
+        {
+            std::ifstream ifs(filename, std::ios::binary);
+            ifs.rdbuf()->pubsetbuf(buffer.data(), bufferSize);
+            for (size_t offset = 0; offset < fileBytes; offset += 4096) {
+                ifs.read(data.data() + offset, std::min<size_t>(4096, fileBytes - offset));
+            }
+        }
+        long long elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::high_resolution_clock::now() - start).count();
+        if (bestTime < 0 || elapsed < bestTime) {
+            bestTime = elapsed;
+            bestSize = bufferSize;
+        }
+    }
+    std::remove(filename.c_str());
+    return bestSize;
+}
+
+/// <summary>
+///    :    
+/// (       ),
+///   ,   -,      sizes -
+///     (merge, radix, sample)   .
+/// </summary>
+/// <param name="sizes">   .</param>
+/// <param name="maxThreads">    (0 -    ).</param>
+/// <returns>;   applySortProfile    saveSortProfile.</returns>
+inline SortProfile calibrateSortProfile(const std::vector<size_t>& sizes = calibrationSizes, size_t maxThreads = 0) {
+    if (maxThreads == 0) {
+        maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    SortTuning previous = sortTuning;
+    SortProfile profile;
+    sortTuning.maxThreads = maxThreads;
+
+    //   :     
+    std::vector<size_t> threadCounts;
+    for (size_t threads = 1; threads < maxThreads; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(maxThreads);
+
+    for (size_t size : sizes) {
+        std::vector<int> input = generateRandomArray<int, ThreadPolicy>(size, maxThreads);
+        //     ,      
+        size_t repeats = std::clamp<size_t>(1000000 / std::max<size_t>(size, 1), 1, 5);
+        SizeClassTuning best;
+        best.maxSize = size;
+        long long bestTime = -1;
+        for (SortAlgorithm algorithm : { SortAlgorithm::Merge, SortAlgorithm::Radix, SortAlgorithm::Sample }) {
+            for (size_t threads : threadCounts) {
+                long long elapsed = timeSort(input, algorithm, threads, repeats);
+                if (bestTime < 0 || elapsed < bestTime) {
+                    bestTime = elapsed;
+                    best.threads = threads;
+                    best.algorithm = algorithm;
+                }
+            }
+        }
+        profile.classes.push_back(best);
+    }
+
+    //  ,        ,   
+    profile.tuning.maxThreads = 1;
+    for (const SizeClassTuning& sizeClass : profile.classes) {
+        profile.tuning.maxThreads = std::max(profile.tuning.maxThreads, sizeClass.threads);
+    }
+    if (profile.classes.empty()) profile.tuning.maxThreads = maxThreads;
+
+    //            
+    if (profile.tuning.maxThreads > 1 && !sizes.empty()) {
+        std::vector<int> input = generateRandomArray<int, ThreadPolicy>(sizes.back(), maxThreads);
+        long long bestTime = -1;
+        for (size_t grain : { size_t(16384), size_t(65536), size_t(262144), size_t(1048576) }) {
+            sortTuning.mergeGrain = grain;
+            long long elapsed = timeSort(input, SortAlgorithm::Merge, profile.tuning.maxThreads, 2);
+            if (bestTime < 0 || elapsed < bestTime) {
+                bestTime = elapsed;
+                profile.tuning.mergeGrain = grain;
+            }
+        }
+    }
+    profile.tuning.ioBufferSize = calibrateIoBufferSize();
+    sortTuning = previous;
+    return profile;
+}
+
+/// <summary>
+///  ,  ,      .
+/// </summary>
+/// <returns>true,   .</returns>
+inline bool calibrateAndSaveSortProfile(const std::string& filename = defaultSortProfileFile) {
+    std::cout << "Calibrating sort profile...\n";
+    SortProfile profile = calibrateSortProfile();
+    std::cout << "  max threads " << profile.tuning.maxThreads << ", merge grain " << profile.tuning.mergeGrain
+        << ", I/O buffer " << profile.tuning.ioBufferSize << "\n";
+    for (const SizeClassTuning& sizeClass : profile.classes) {
+        std::cout << "  up to " << sizeClass.maxSize << ": " << algorithmName(sizeClass.algorithm)
+            << ", " << sizeClass.threads << " threads\n";
+    }
+    applySortProfile(profile);
+    return saveSortProfile(profile, filename);
+}
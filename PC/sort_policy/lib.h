@@ -0,0 +1,761 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <random>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <cstring>
+#include <fstream>
+#include <type_traits>
+#include <msgpack.hpp>
+#include "../async_io/lib.h"
+#include "scratch_pool.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#if __has_include(<execution>)
+#include <execution>
+#endif
+
+//        (libstdc++  TBB)
+#if defined(__cpp_lib_execution) && defined(__cpp_lib_parallel_algorithm)
+#define SORT_POLICY_HAS_STD_PAR 1
+#else
+#define SORT_POLICY_HAS_STD_PAR 0
+#endif
+
+///    
+constexpr size_t maxSortThreads = 16;
+
+///   ,    
+constexpr size_t parallelMergeGrain = 65536;
+
+///    -  
+constexpr size_t defaultIoBufferSize = 1048576;
+
+/// <summary>
+///  ,       (,   autotune.h).
+///       .
+/// </summary>
+struct SortTuning {
+    size_t maxThreads = maxSortThreads;        //    
+    size_t mergeGrain = parallelMergeGrain;    //   ,    
+    size_t ioBufferSize = defaultIoBufferSize; //      
+};
+
+///   ;    ,     
+inline SortTuning sortTuning;
+
+///      (    )
+inline const std::vector<size_t> performanceSizes = { 5000000, 10000000, 20000000, 30000000, 40000000, 50000000, 60000000, 80000000 };
+
+/// <summary>
+///  :     .
+/// </summary>
+struct SerialPolicy {};
+
+/// <summary>
+///  :  std::thread,     .
+/// </summary>
+struct ThreadPolicy {};
+
+#ifdef _OPENMP
+/// <summary>
+///  :   OpenMP.
+/// </summary>
+struct OpenMPPolicy {};
+#endif
+
+#if SORT_POLICY_HAS_STD_PAR
+/// <summary>
+///  :     (std::execution::par).
+/// </summary>
+struct StdParPolicy {};
+#endif
+
+/// <summary>
+///    .
+/// </summary>
+struct SortTimings {
+    long long sortMs = 0;      //  
+    long long mergeMs = 0;     //  
+    long long minorFaults = 0; //        
+    long long majorFaults = 0; //        
+};
+
+/// <summary>
+///        .
+/// </summary>
+/// <typeparam name="T">   (int, float)</typeparam>
+/// <param name="arr">,    .</param>
+/// <param name="left">   .</param>
+/// <param name="mid">   .</param>
+/// <param name="right">   .</param>
+/// <param name="temp">      (std::vector  ScratchBuffer).</param>
+template <typename T, typename Buffer = std::vector<T>>
+void merge(std::vector<T>& arr, size_t left, size_t mid, size_t right, Buffer& temp) {
+    size_t i = left, j = mid + 1, k = left;
+
+    //         
+    while (i <= mid && j <= right) {
+        if (arr[i] <= arr[j]) {
+            temp[k++] = arr[i++]; //     
+        }
+        else {
+            temp[k++] = arr[j++]; //     
+        }
+    }
+
+    //     
+    while (i <= mid) {
+        temp[k++] = arr[i++];
+    }
+
+    //     
+    while (j <= right) {
+        temp[k++] = arr[j++];
+    }
+
+    //       
+    std::memcpy(&arr[left], &temp[left], (right - left + 1) * sizeof(T));
+}
+
+/// <summary>
+///        .
+/// </summary>
+/// <typeparam name="T">   (int, float)</typeparam>
+/// <param name="arr">  .</param>
+/// <param name="left">  .</param>
+/// <param name="right">  .</param>
+/// <param name="temp">    (std::vector  ScratchBuffer).</param>
+template <typename T, typename Buffer = std::vector<T>>
+void mergeSort(std::vector<T>& arr, size_t left, size_t right, Buffer& temp) {
+    if (left < right) {
+        //   
+        size_t mid = left + (right - left) / 2;
+        //    
+        mergeSort(arr, left, mid, temp);
+        //    
+        mergeSort(arr, mid + 1, right, temp);
+        //   
+        merge(arr, left, mid, right, temp);
+    }
+}
+
+/// <summary>
+///      .
+/// </summary>
+/// <typeparam name="T">   (int, float)</typeparam>
+/// <param name="arr">  .</param>
+template <typename T>
+void singleThreadMergeSort(std::vector<T>& arr) {
+    if (arr.empty()) return; //   
+    //     :      
+    ScratchBuffer<T> temp(arr.size());
+    //   
+    mergeSort(arr, 0, arr.size() - 1, temp);
+}
+
+/// <summary>
+/// ,        k   .
+///       ,   merge.
+/// </summary>
+/// <typeparam name="T">   (int, float)</typeparam>
+/// <param name="a">  .</param>
+/// <param name="na">  .</param>
+/// <param name="b">  .</param>
+/// <param name="nb">  .</param>
+/// <param name="k">   .</param>
+/// <returns>   a    k.</returns>
+template <typename T>
+size_t mergeCoRank(const T* a, size_t na, const T* b, size_t nb, size_t k) {
+    size_t lo = k > nb ? k - nb : 0;
+    size_t hi = std::min(k, na);
+    while (lo < hi) {
+        size_t i = lo + (hi - lo) / 2;
+        size_t j = k - i;
+        // b[j - 1]   a[i]: a[i]     
+        if (j > 0 && b[j - 1] >= a[i]) {
+            lo = i + 1;
+        }
+        else {
+            hi = i;
+        }
+    }
+    return lo;
+}
+
+/// <summary>
+///       dst.
+/// </summary>
+template <typename T>
+void mergeSortedRanges(const T* a, size_t na, const T* b, size_t nb, T* dst) {
+    size_t i = 0, j = 0, k = 0;
+    //      
+    while (i < na && j < nb) {
+        dst[k++] = (a[i] <= b[j]) ? a[i++] : b[j++];
+    }
+    //   
+    while (i < na) dst[k++] = a[i++];
+    while (j < nb) dst[k++] = b[j++];
+}
+
+/// <summary>
+///   .       .
+/// parallelFor(count, numThreads, body)  body(first, last)    [0, count).
+/// </summary>
+/// <typeparam name="Policy"> .</typeparam>
+template <typename Policy>
+struct ExecutionBackend;
+
+template <>
+struct ExecutionBackend<SerialPolicy> {
+    static constexpr const char* name = "serial";
+
+    template <typename Body>
+    static void parallelFor(size_t count, size_t, Body&& body) {
+        if (count > 0) body(size_t(0), count); //    
+    }
+};
+
+template <>
+struct ExecutionBackend<ThreadPolicy> {
+    static constexpr const char* name = "std::thread";
+
+    template <typename Body>
+    static void parallelFor(size_t count, size_t numThreads, Body&& body) {
+        numThreads = std::max<size_t>(1, std::min(numThreads, count));
+        size_t blockSize = (count + numThreads - 1) / std::max<size_t>(numThreads, 1);
+        std::vector<std::thread> threads;
+        //  ,  ,    
+        for (size_t first = 0; first + blockSize < count; first += blockSize) {
+            threads.emplace_back([&body, first, blockSize] { body(first, first + blockSize); });
+        }
+        //      
+        if (count > 0) {
+            size_t lastFirst = ((count - 1) / blockSize) * blockSize;
+            body(lastFirst, count);
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+};
+
+#ifdef _OPENMP
+template <>
+struct ExecutionBackend<OpenMPPolicy> {
+    static constexpr const char* name = "OpenMP";
+
+    template <typename Body>
+    static void parallelFor(size_t count, size_t numThreads, Body&& body) {
+        numThreads = std::max<size_t>(1, std::min(numThreads, count));
+        size_t blockSize = (count + numThreads - 1) / numThreads;
+        long long blocks = static_cast<long long>(numThreads);
+        //     
+        #pragma omp parallel for schedule(static, 1) num_threads(static_cast<int>(numThreads))
+        for (long long block = 0; block < blocks; ++block) {
+            size_t first = static_cast<size_t>(block) * blockSize;
+            if (first < count) {
+                body(first, std::min(first + blockSize, count));
+            }
+        }
+    }
+};
+#endif
+
+#if SORT_POLICY_HAS_STD_PAR
+template <>
+struct ExecutionBackend<StdParPolicy> {
+    static constexpr const char* name = "std::execution::par";
+
+    template <typename Body>
+    static void parallelFor(size_t count, size_t numThreads, Body&& body) {
+        numThreads = std::max<size_t>(1, std::min(numThreads, count));
+        size_t blockSize = (count + numThreads - 1) / numThreads;
+        std::vector<size_t> blocks(numThreads);
+        for (size_t i = 0; i < numThreads; ++i) {
+            blocks[i] = i * blockSize;
+        }
+        //     
+        std::for_each(std::execution::par, blocks.begin(), blocks.end(), [&](size_t first) {
+            if (first < count) {
+                body(first, std::min(first + blockSize, count));
+            }
+        });
+    }
+};
+#endif
+
+/// <summary>
+///     ,        .
+///     mergeCoRank,       .
+/// </summary>
+/// <typeparam name="Policy"> .</typeparam>
+/// <typeparam name="T">   (int, float)</typeparam>
+/// <param name="arr">,    .</param>
+/// <param name="left">   .</param>
+/// <param name="mid">   .</param>
+/// <param name="right">   .</param>
+/// <param name="temp">   arr (std::vector  ScratchBuffer).</param>
+/// <param name="numThreads"> .</param>
+template <typename Policy, typename T, typename Buffer = std::vector<T>>
+void policyMerge(std::vector<T>& arr, size_t left, size_t mid, size_t right, Buffer& temp, size_t numThreads) {
+    size_t total = right - left + 1;
+    if (std::is_same_v<Policy, SerialPolicy> || numThreads <= 1 || total < sortTuning.mergeGrain) {
+        merge(arr, left, mid, right, temp);
+        return;
+    }
+
+#if SORT_POLICY_HAS_STD_PAR
+    if constexpr (std::is_same_v<Policy, StdParPolicy>) {
+        //      
+        std::merge(std::execution::par, arr.begin() + left, arr.begin() + mid + 1,
+            arr.begin() + mid + 1, arr.begin() + right + 1, temp.begin() + left);
+        std::copy(std::execution::par, temp.begin() + left, temp.begin() + right + 1, arr.begin() + left);
+        return;
+    }
+#endif
+
+    const T* a = arr.data() + left;
+    const T* b = arr.data() + mid + 1;
+    size_t na = mid - left + 1;
+    size_t nb = right - mid;
+    //         
+    ExecutionBackend<Policy>::parallelFor(numThreads, numThreads, [&](size_t first, size_t last) {
+        for (size_t part = first; part < last; ++part) {
+            size_t k0 = total * part / numThreads;
+            size_t k1 = total * (part + 1) / numThreads;
+            size_t i0 = mergeCoRank(a, na, b, nb, k0);
+            size_t i1 = mergeCoRank(a, na, b, nb, k1);
+            mergeSortedRanges(a + i0, i1 - i0, b + (k0 - i0), (k1 - i1) - (k0 - i0), temp.data() + left + k0);
+        }
+    });
+    //      
+    ExecutionBackend<Policy>::parallelFor(total, numThreads, [&](size_t first, size_t last) {
+        std::memcpy(arr.data() + left + first, temp.data() + left + first, (last - first) * sizeof(T));
+    });
+}
+
+/// <summary>
+///   [first, last) :    ,
+///   ,      .
+/// </summary>
+/// <typeparam name="Policy"> .</typeparam>
+/// <typeparam name="T">   (int, float)</typeparam>
+/// <param name="arr">,  .</param>
+/// <param name="first">  .</param>
+/// <param name="last">   .</param>
+/// <param name="temp">   arr (std::vector  ScratchBuffer).</param>
+/// <param name="numThreads"> .</param>
+/// <param name="timings">   .</param>
+template <typename Policy, typename T, typename Buffer>
+void policyMergeSortRange(std::vector<T>& arr, size_t first, size_t last, Buffer& temp, size_t numThreads, SortTimings* timings = nullptr) {
+    size_t n = last - first;
+    if (n == 0) return; //   
+    numThreads = std::max<size_t>(1, std::min(numThreads, n));
+    //      ,     
+    size_t chunkSize = (n + numThreads - 1) / numThreads;
+
+    //   
+    auto startSort = std::chrono::high_resolution_clock::now();
+    ExecutionBackend<Policy>::parallelFor(numThreads, numThreads, [&](size_t firstChunk, size_t lastChunk) {
+        for (size_t chunk = firstChunk; chunk < lastChunk; ++chunk) {
+            size_t left = first + chunk * chunkSize;
+            if (left < last) {
+                mergeSort(arr, left, std::min(left + chunkSize, last) - 1, temp);
+            }
+        }
+    });
+    auto endSort = std::chrono::high_resolution_clock::now();
+
+    //    ,     
+    auto startMerge = std::chrono::high_resolution_clock::now();
+    size_t currentSize = chunkSize;
+    while (currentSize < n) {
+        for (size_t i = first; i < last; i += currentSize * 2) {
+            size_t left = i;
+            size_t mid = std::min(i + currentSize, last) - 1;
+            size_t right = std::min(i + 2 * currentSize, last) - 1;
+            if (mid < right) {
+                policyMerge<Policy>(arr, left, mid, right, temp, numThreads);
+            }
+        }
+        currentSize *= 2; //    
+    }
+    auto endMerge = std::chrono::high_resolution_clock::now();
+
+    if (timings) {
+        timings->sortMs = std::chrono::duration_cast<std::chrono::milliseconds>(endSort - startSort).count();
+        timings->mergeMs = std::chrono::duration_cast<std::chrono::milliseconds>(endMerge - startMerge).count();
+    }
+}
+
+/// <summary>
+///           .
+///       ,   , 
+///  ;       .
+/// </summary>
+/// <typeparam name="Policy"> .</typeparam>
+/// <typeparam name="T">   (int, float)</typeparam>
+/// <param name="arr">  .</param>
+/// <param name="numThreads"> .</param>
+/// <param name="timings">   .</param>
+template <typename Policy, typename T>
+void policyMergeSort(std::vector<T>& arr, size_t numThreads, SortTimings* timings = nullptr) {
+    size_t n = arr.size();
+    if (n == 0) return; //   
+
+    auto startSort = std::chrono::high_resolution_clock::now();
+    PageFaults startFaults = currentPageFaults();
+    //      
+    auto recordFaults = [&]() {
+        if (timings) {
+            PageFaults endFaults = currentPageFaults();
+            timings->minorFaults = endFaults.minor - startFaults.minor;
+            timings->majorFaults = endFaults.major - startFaults.major;
+        }
+    };
+
+    if (std::is_same_v<Policy, SerialPolicy> || numThreads <= 1) {
+        //      
+        singleThreadMergeSort(arr);
+        if (timings) {
+            timings->sortMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::high_resolution_clock::now() - startSort).count();
+            timings->mergeMs = 0;
+        }
+        recordFaults();
+        return;
+    }
+
+#if SORT_POLICY_HAS_STD_PAR
+    if constexpr (std::is_same_v<Policy, StdParPolicy>) {
+        //      ( )
+        std::stable_sort(std::execution::par, arr.begin(), arr.end());
+        if (timings) {
+            timings->sortMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::high_resolution_clock::now() - startSort).count();
+            timings->mergeMs = 0;
+        }
+        recordFaults();
+        return;
+    }
+#endif
+
+    //   
+    numThreads = std::min({ numThreads, n, sortTuning.maxThreads });
+    //     ;      
+    ScratchBuffer<T> temp(n);
+    policyMergeSortRange<Policy>(arr, 0, n, temp, numThreads, timings);
+    recordFaults();
+}
+
+/// <summary>
+///       [-100, 100].
+///      .
+/// </summary>
+/// <typeparam name="T">   (int, float)</typeparam>
+/// <typeparam name="Policy"> .</typeparam>
+/// <param name="size">  .</param>
+/// <param name="numThreads"> .</param>
+/// <returns>    T.</returns>
+template <typename T, typename Policy = SerialPolicy>
+std::vector<T> generateRandomArray(size_t size, size_t numThreads = 1) {
+    //    
+    std::vector<T> arr(size);
+    ExecutionBackend<Policy>::parallelFor(size, numThreads, [&arr](size_t first, size_t last) {
+        //      
+        std::random_device rd;
+        std::mt19937 gen(rd());
+        if constexpr (std::is_integral_v<T>) {
+            //      [-100, 100]
+            std::uniform_int_distribution<> dis(-100, 100);
+            for (size_t i = first; i < last; ++i) {
+                arr[i] = dis(gen); //     
+            }
+        }
+        else if constexpr (std::is_floating_point_v<T>) {
+            //      [-100, 100]
+            std::uniform_real_distribution<> dis(-100.0, 100.0);
+            for (size_t i = first; i < last; ++i) {
+                arr[i] = dis(gen); //     
+            }
+        }
+    });
+    return arr;
+}
+
+/// <summary>
+///       MessagePack.
+///       ,     .
+/// </summary>
+/// <typeparam name="Policy"> .</typeparam>
+/// <typeparam name="T">   (int, float)</typeparam>
+/// <param name="arr">  .</param>
+/// <param name="filename">   .</param>
+/// <param name="numThreads">  .</param>
+/// <returns>true,   ,  false.</returns>
+template <typename Policy = SerialPolicy, typename T>
+bool writeArrayMsgpack(const std::vector<T>& arr, const std::string& filename, size_t numThreads = 1) {
+    try {
+        //       
+        std::ofstream ofs(filename, std::ios::binary);
+        if (!ofs.is_open()) {
+            std::cerr << "Error: Cannot open file " << filename << " for writing.\n";
+            return false;
+        }
+
+        //     
+        size_t bufferSize = sortTuning.ioBufferSize;
+        std::vector<char> buffer(bufferSize);
+        ofs.rdbuf()->pubsetbuf(buffer.data(), bufferSize);
+
+        //   
+        auto start = std::chrono::high_resolution_clock::now();
+        // : map    "array"   
+        msgpack::sbuffer header;
+        msgpack::packer<msgpack::sbuffer> pk(&header);
+        pk.pack_map(1);
+        pk.pack(std::string("array"));
+        pk.pack_array(arr.size());
+        ofs.write(header.data(), header.size());
+
+        //    ,     
+        numThreads = std::max<size_t>(1, std::min(numThreads, arr.size()));
+        std::vector<msgpack::sbuffer> parts(numThreads);
+        size_t blockSize = arr.empty() ? 0 : (arr.size() + numThreads - 1) / numThreads;
+        ExecutionBackend<Policy>::parallelFor(numThreads, numThreads, [&](size_t first, size_t last) {
+            for (size_t part = first; part < last; ++part) {
+                msgpack::packer<msgpack::sbuffer> partPacker(&parts[part]);
+                size_t end = std::min(arr.size(), (part + 1) * blockSize);
+                for (size_t i = part * blockSize; i < end; ++i) {
+                    partPacker.pack(arr[i]); //   
+                }
+            }
+        });
+        //      
+        for (const auto& part : parts) {
+            ofs.write(part.data(), part.size());
+        }
+        //  
+        ofs.close();
+
+        //   
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << "Msgpack write time: "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+            << " ms\n";
+        return true;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error writing Msgpack to " << filename << ": " << e.what() << "\n";
+        return false;
+    }
+}
+
+/// <summary>
+///     MessagePack   .
+///        .
+/// </summary>
+/// <typeparam name="Policy"> .</typeparam>
+/// <typeparam name="T">   (int, float)</typeparam>
+/// <param name="data"> .</param>
+/// <param name="size"> .</param>
+/// <param name="arr">    .</param>
+/// <param name="numThreads">  .</param>
+/// <returns>true,   ,  false.</returns>
+template <typename Policy = SerialPolicy, typename T>
+bool decodeArrayMsgpack(const char* data, size_t size, std::vector<T>& arr, size_t numThreads = 1) {
+    //   MessagePack
+    msgpack::object_handle oh = msgpack::unpack(data, size);
+    msgpack::object obj = oh.get();
+    //  : map   
+    if (obj.type != msgpack::type::MAP || obj.via.map.size != 1) {
+        std::cerr << "Error: Invalid Msgpack format. Expected map with one key.\n";
+        return false;
+    }
+    auto& kv = obj.via.map.ptr[0];
+    //   "array"    ()
+    if (kv.key.as<std::string>() != "array" || kv.val.type != msgpack::type::ARRAY) {
+        std::cerr << "Error: Expected key 'array' with array value.\n";
+        return false;
+    }
+    auto& array = kv.val.via.array;
+    //     
+    arr.assign(array.size, T{});
+    //         (array.size -  )
+    numThreads = std::max<size_t>(1, numThreads);
+    std::vector<size_t> badIndex(numThreads, array.size);
+    size_t blockSize = (array.size + numThreads - 1) / numThreads;
+    ExecutionBackend<Policy>::parallelFor(numThreads, numThreads, [&](size_t first, size_t last) {
+        for (size_t part = first; part < last; ++part) {
+            size_t end = std::min<size_t>(array.size, (part + 1) * blockSize);
+            for (size_t i = part * blockSize; i < end; ++i) {
+                auto type = array.ptr[i].type;
+                bool isInteger = type == msgpack::type::POSITIVE_INTEGER || type == msgpack::type::NEGATIVE_INTEGER;
+                //     ,  -  float
+                bool valid = std::is_integral_v<T> ? isInteger
+                    : (isInteger || type == msgpack::type::FLOAT32 || type == msgpack::type::FLOAT64);
+                if (!valid) {
+                    badIndex[part] = i;
+                    break;
+                }
+                arr[i] = array.ptr[i].as<T>(); //    T
+            }
+        }
+    });
+    size_t firstBad = *std::min_element(badIndex.begin(), badIndex.end());
+    if (firstBad != array.size) {
+        std::cerr << "Error: Msgpack array contains " << (std::is_integral_v<T> ? "non-integer" : "non-float")
+            << " value at index " << firstBad << ".\n";
+        arr.clear();
+        return false;
+    }
+    return true;
+}
+
+/// <summary>
+///       MessagePack.
+///        .
+/// </summary>
+/// <typeparam name="Policy"> .</typeparam>
+/// <typeparam name="T">   (int, float)</typeparam>
+/// <param name="arr">    .</param>
+/// <param name="filename">   .</param>
+/// <param name="numThreads">  .</param>
+/// <returns>true,   ,  false.</returns>
+template <typename Policy = SerialPolicy, typename T>
+bool readArrayMsgpack(std::vector<T>& arr, const std::string& filename, size_t numThreads = 1) {
+    try {
+        //       
+        std::ifstream ifs(filename, std::ios::binary);
+        if (!ifs.is_open()) {
+            std::cerr << "Error: Cannot open file " << filename << " for reading.\n";
+            return false;
+        }
+        //     
+        size_t bufferSize = sortTuning.ioBufferSize;
+        std::vector<char> buffer(bufferSize);
+        ifs.rdbuf()->pubsetbuf(buffer.data(), bufferSize);
+        //   
+        auto start = std::chrono::high_resolution_clock::now();
+        //   
+        ifs.seekg(0, std::ios::end);
+        size_t fileSize = ifs.tellg();
+        ifs.seekg(0, std::ios::beg);
+        //     
+        std::vector<char> fileBuffer(fileSize);
+        //    
+        ifs.read(fileBuffer.data(), fileSize);
+        //  
+        ifs.close();
+        if (!decodeArrayMsgpack<Policy>(fileBuffer.data(), fileSize, arr, numThreads)) return false;
+        //   
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << "Msgpack read time: "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+            << " ms\n";
+        return true;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error reading Msgpack from " << filename << ": " << e.what() << "\n";
+        return false;
+    }
+}
+
+/// <summary>
+///       MessagePack  (../async_io/lib.h):
+///  Linux    io_uring   ,    
+///    ,  io_uring   pread.
+/// </summary>
+/// <typeparam name="Policy"> .</typeparam>
+/// <typeparam name="T">   (int, float)</typeparam>
+/// <param name="arr">    .</param>
+/// <param name="filename">   .</param>
+/// <param name="numThreads">  .</param>
+/// <param name="options">     .</param>
+/// <returns>true,   ,  false.</returns>
+template <typename Policy = SerialPolicy, typename T>
+bool readArrayMsgpackAsync(std::vector<T>& arr, const std::string& filename, size_t numThreads = 1,
+    const AsyncReadOptions& options = {}) {
+    try {
+        //   
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<char> fileBuffer;
+        if (!readWholeFileAsync(filename, fileBuffer, options)) return false;
+        if (!decodeArrayMsgpack<Policy>(fileBuffer.data(), fileBuffer.size(), arr, numThreads)) return false;
+        //   
+        auto end = std::chrono::high_resolution_clock::now();
+        std::cout << "Msgpack async read time: "
+            << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count()
+            << " ms\n";
+        return true;
+    }
+    catch (const std::exception& e) {
+        std::cerr << "Error reading Msgpack from " << filename << ": " << e.what() << "\n";
+        return false;
+    }
+}
+
+/// <summary>
+/// ,     .
+/// </summary>
+/// <typeparam name="T">   (int, float)</typeparam>
+/// <param name="arr">  .</param>
+/// <returns>true,   ,  false.</returns>
+template <typename T>
+bool isSorted(const std::vector<T>& arr) {
+    // ,      
+    for (size_t i = 1; i < arr.size(); ++i) {
+        if (arr[i] < arr[i - 1]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/// <summary>
+///       Policy     .
+/// </summary>
+/// <typeparam name="Policy"> .</typeparam>
+/// <param name="input">     .</param>
+/// <param name="numThreads"> .</param>
+/// <param name="reference">  .</param>
+template <typename Policy>
+void benchmarkPolicy(const std::vector<int>& input, size_t numThreads, const std::vector<int>& reference) {
+    std::vector<int> arr = input;
+    SortTimings timings;
+    auto start = std::chrono::high_resolution_clock::now();
+    policyMergeSort<Policy>(arr, numThreads, &timings);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "  " << ExecutionBackend<Policy>::name << ": "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms"
+        << " (sort " << timings.sortMs << " ms, merge " << timings.mergeMs << " ms, page faults " << timings.minorFaults << ")"
+        << (arr == reference ? "" : " WRONG RESULT") << "\n";
+}
+
+/// <summary>
+///         .
+/// </summary>
+/// <param name="numThreads"> .</param>
+/// <param name="sizes"> .</param>
+inline void comparePolicies(size_t numThreads, const std::vector<size_t>& sizes = performanceSizes) {
+    for (size_t size : sizes) {
+        //       
+        std::vector<int> input = generateRandomArray<int, ThreadPolicy>(size, numThreads);
+        std::vector<int> reference = input;
+        std::sort(reference.begin(), reference.end());
+        std::cout << "Array size: " << size << ", Threads: " << numThreads << "\n";
+        benchmarkPolicy<SerialPolicy>(input, numThreads, reference);
+        benchmarkPolicy<ThreadPolicy>(input, numThreads, reference);
+#ifdef _OPENMP
+        benchmarkPolicy<OpenMPPolicy>(input, numThreads, reference);
+#endif
+#if SORT_POLICY_HAS_STD_PAR
+        benchmarkPolicy<StdParPolicy>(input, numThreads, reference);
+#endif
+        std::cout << "------------------------\n";
+    }
+}
@@ -0,0 +1,44 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include "lib.h"
+#include "segmented_sort.h"
+#include "quantile_sketch.h"
+#include "sorted_stream.h"
+#include "autotune.h"
+
+int main(int argc, char* argv[]) {
+    //    ,     
+    if (argc > 1 && std::string(argv[1]) == "--calibrate") {
+        return calibrateAndSaveSortProfile() ? 0 : 1;
+    }
+    if (loadSortProfileAtStartup()) {
+        std::cout << "Loaded sort profile " << defaultSortProfileFile << "\n";
+    }
+
+    size_t numThreads;
+
+    //   ;      
+    std::cout << "Enter the number of threads (max " << sortTuning.maxThreads << ", Enter - from sort profile): ";
+    if (!readThreadCount(std::cin, numThreads)) {
+        std::cerr << "Error: Invalid number of threads. Must be between 1 and " << sortTuning.maxThreads << ".\n";
+        return 1;
+    }
+    if (numThreads == 0) {
+        //         
+        compareAutoSort();
+        numThreads = sortTuning.maxThreads;
+    }
+
+    //       
+    comparePolicies(numThreads);
+    //         
+    compareSegmentedSort(numThreads);
+    //      
+    compareQuantiles(numThreads);
+    //         
+    compareSortedStream(numThreads);
+
+    std::cout << "All benchmarks completed successfully.\n";
+    return 0;
+}
@@ -0,0 +1,15 @@
+//
+// pch.h
+//
+
+#pragma once
+
+#include <gtest/gtest.h>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include "lib.h"
+#include "segmented_sort.h"
+#include "quantile_sketch.h"
+#include "sorted_stream.h"
+#include "autotune.h"
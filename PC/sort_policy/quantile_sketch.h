@@ -0,0 +1,474 @@
+#pragma once
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include "lib.h"
+
+///  k   :     1.3%
+constexpr size_t defaultSketchK = 200;
+
+///    
+constexpr size_t minSketchLevelWidth = 8;
+
+///   ,        
+constexpr size_t quantileScanTile = 4096;
+
+/// <summary>
+///      KLL   k
+/// (     99%).
+/// </summary>
+/// <param name="k">  .</param>
+/// <returns>  ,    .</returns>
+inline double sketchRankError(size_t k) {
+    return 2.296 / std::pow(static_cast<double>(k), 0.9723);
+}
+
+/// <summary>
+///    k,       epsilon.
+/// </summary>
+/// <param name="epsilon">   ,  0.01.</param>
+/// <returns> k  KllSketch.</returns>
+inline size_t sketchKForError(double epsilon) {
+    size_t k = static_cast<size_t>(std::ceil(std::pow(2.296 / epsilon, 1.0 / 0.9723)));
+    return std::max(k, minSketchLevelWidth);
+}
+
+/// <summary>
+///   KLL:  O(k log(n / k))     
+///       sketchRankError(k).
+///  h    2^h;   ,
+///           .
+///    ,     k,   
+/// :     2^s        ,
+///      O(1)  .
+/// ,    ,    .
+/// </summary>
+/// <typeparam name="T">   (int, float)</typeparam>
+template <typename T>
+class KllSketch {
+public:
+    explicit KllSketch(size_t k = defaultSketchK, uint32_t seed = 1)
+        : k_(std::max(k, minSketchLevelWidth)), gen_(seed) {
+        // ,        
+        while (static_cast<double>(k_) * std::pow(2.0 / 3.0, static_cast<double>(activeLevels_)) >= minSketchLevelWidth) {
+            ++activeLevels_;
+        }
+        addLevel();
+    }
+
+    /// <summary>
+    ///  count   data.
+    /// </summary>
+    void update(const T* data, size_t count) {
+        if (count == 0) return;
+        //      
+        auto [low, high] = std::minmax_element(data, data + count);
+        if (n_ == 0 || *low < min_) min_ = *low;
+        if (n_ == 0 || max_ < *high) max_ = *high;
+        while (count > 0) {
+            size_t take;
+            if (sampleLevel_ == 0) {
+                //      ,    
+                size_t room = capacity_ > retained_ ? capacity_ - retained_ : 1;
+                take = std::min(room, count);
+                levels_[0].insert(levels_[0].end(), data, data + take);
+                retained_ += take;
+            }
+            else {
+                //   ,    
+                size_t blockSize = size_t(1) << sampleLevel_;
+                take = std::min(count, blockSize - blockPos_);
+                if (blockPick_ >= blockPos_ && blockPick_ < blockPos_ + take) {
+                    levels_[sampleLevel_].push_back(data[blockPick_ - blockPos_]);
+                    ++retained_;
+                }
+                blockPos_ += take;
+                if (blockPos_ == blockSize) {
+                    startBlock();
+                }
+            }
+            n_ += take;
+            data += take;
+            count -= take;
+            compress();
+        }
+    }
+
+    /// <summary>
+    ///   .
+    /// </summary>
+    void update(T value) {
+        update(&value, 1);
+    }
+
+    /// <summary>
+    ///           k.
+    /// </summary>
+    void merge(const KllSketch& other) {
+        if (other.n_ == 0) return;
+        if (n_ == 0 || other.min_ < min_) min_ = other.min_;
+        if (n_ == 0 || max_ < other.max_) max_ = other.max_;
+        while (levels_.size() < other.levels_.size()) {
+            addLevel();
+        }
+        //       
+        while (sampleLevel_ < other.sampleLevel_) {
+            raiseSampleLevel();
+        }
+        for (size_t h = 0; h < other.levels_.size(); ++h) {
+            levels_[h].insert(levels_[h].end(), other.levels_[h].begin(), other.levels_[h].end());
+        }
+        retained_ += other.retained_;
+        n_ += other.n_;
+        //           
+        //       
+        for (size_t h = 0; h < sampleLevel_; ++h) {
+            if (!levels_[h].empty()) compactLevel(h, true);
+        }
+        compress();
+    }
+
+    /// <summary>
+    ///   : ,    q * size().
+    ///  0  1      .
+    /// </summary>
+    /// <param name="q">  0  1.</param>
+    T quantile(double q) const {
+        return quantiles({ q }).front();
+    }
+
+    /// <summary>
+    ///          .
+    /// </summary>
+    /// <param name="qs">  0  1.</param>
+    std::vector<T> quantiles(const std::vector<double>& qs) const {
+        std::vector<std::pair<T, uint64_t>> weighted = weightedItems();
+        std::vector<T> result;
+        result.reserve(qs.size());
+        for (double q : qs) {
+            if (weighted.empty() || q <= 0.0 || q >= 1.0) {
+                result.push_back(n_ == 0 ? T() : (q <= 0.0 ? min_ : max_));
+                continue;
+            }
+            //  ,      q   
+            double rank = q * static_cast<double>(weighted.back().second);
+            auto it = std::upper_bound(weighted.begin(), weighted.end(), rank,
+                [](double r, const std::pair<T, uint64_t>& item) { return r < static_cast<double>(item.second); });
+            result.push_back(it == weighted.end() ? weighted.back().first : it->first);
+        }
+        return result;
+    }
+
+    /// <summary>
+    ///    ,  value.
+    /// </summary>
+    double rank(T value) const {
+        uint64_t below = 0, total = 0;
+        for (size_t h = 0; h < levels_.size(); ++h) {
+            for (const T& item : levels_[h]) {
+                if (item < value) below += uint64_t(1) << h;
+                total += uint64_t(1) << h;
+            }
+        }
+        return total == 0 ? 0.0 : static_cast<double>(below) / static_cast<double>(total);
+    }
+
+    /// <summary>
+    ///   .
+    /// </summary>
+    uint64_t size() const { return n_; }
+
+    /// <summary>
+    ///   .
+    /// </summary>
+    size_t retained() const { return retained_; }
+
+    /// <summary>
+    ///    .
+    /// </summary>
+    double rankError() const { return sketchRankError(k_); }
+
+    size_t k() const { return k_; }
+
+private:
+    /// <summary>
+    ///      .
+    /// </summary>
+    void addLevel() {
+        levels_.emplace_back();
+        updateCapacities();
+    }
+
+    /// <summary>
+    ///       :   
+    /// k ,   -  3/2  .     k:
+    ///        .
+    /// </summary>
+    void updateCapacities() {
+        capacities_.assign(levels_.size(), 0);
+        capacity_ = 0;
+        for (size_t h = sampleLevel_; h < levels_.size(); ++h) {
+            double depth = static_cast<double>(levels_.size() - 1 - h);
+            double width = static_cast<double>(k_) * std::pow(2.0 / 3.0, depth);
+            capacities_[h] = std::max(minSketchLevelWidth, static_cast<size_t>(std::ceil(width)));
+            if (h == sampleLevel_) {
+                capacities_[h] = std::max(capacities_[h], k_);
+            }
+            capacity_ += capacities_[h];
+        }
+    }
+
+    /// <summary>
+    ///          .
+    /// </summary>
+    void startBlock() {
+        blockPos_ = 0;
+        blockPick_ = static_cast<size_t>(gen_()) & ((size_t(1) << sampleLevel_) - 1);
+    }
+
+    /// <summary>
+    ///   h           h + 1.
+    ///        ,   
+    ///  ,    1/2.
+    /// </summary>
+    void compactLevel(size_t h, bool whole) {
+        std::vector<T>& level = levels_[h];
+        std::vector<T>& next = levels_[h + 1];
+        std::sort(level.begin(), level.end());
+        size_t promotedBefore = next.size();
+        size_t first = level.size() % 2;
+        size_t kept = first;
+        if (first == 1 && whole) {
+            if (gen_() & 1) next.push_back(level[0]);
+            kept = 0;
+        }
+        size_t offset = gen_() & 1;
+        for (size_t i = first + offset; i < level.size(); i += 2) {
+            next.push_back(level[i]);
+        }
+        retained_ = retained_ - level.size() + kept + (next.size() - promotedBefore);
+        level.resize(kept);
+    }
+
+    /// <summary>
+    ///     :    ,
+    ///           .
+    /// </summary>
+    void raiseSampleLevel() {
+        compactLevel(sampleLevel_, true);
+        ++sampleLevel_;
+        startBlock();
+        updateCapacities();
+    }
+
+    /// <summary>
+    ///    ,       .
+    /// </summary>
+    void compress() {
+        while (retained_ > capacity_) {
+            size_t h = sampleLevel_;
+            while (h + 1 < levels_.size() && levels_[h].size() < capacities_[h]) ++h;
+            if (h + 1 == levels_.size()) {
+                addLevel();
+            }
+            compactLevel(h, false);
+            if (levels_.size() - sampleLevel_ > activeLevels_) {
+                raiseSampleLevel();
+            }
+        }
+    }
+
+    /// <summary>
+    ///        .
+    /// </summary>
+    std::vector<std::pair<T, uint64_t>> weightedItems() const {
+        std::vector<std::pair<T, uint64_t>> items;
+        items.reserve(retained_);
+        for (size_t h = 0; h < levels_.size(); ++h) {
+            for (const T& item : levels_[h]) {
+                items.emplace_back(item, uint64_t(1) << h);
+            }
+        }
+        std::sort(items.begin(), items.end(),
+            [](const std::pair<T, uint64_t>& a, const std::pair<T, uint64_t>& b) { return a.first < b.first; });
+        uint64_t cumulative = 0;
+        for (auto& item : items) {
+            cumulative += item.second;
+            item.second = cumulative;
+        }
+        return items;
+    }
+
+    size_t k_;
+    std::mt19937 gen_;
+    std::vector<std::vector<T>> levels_; //  h    2^h
+    std::vector<size_t> capacities_;      //   
+    size_t capacity_ = 0;                 //   
+    size_t retained_ = 0;                 //   
+    uint64_t n_ = 0;                      //   
+    T min_ = T();                         //   
+    T max_ = T();                         //   
+    size_t activeLevels_ = 1;             //     
+    size_t sampleLevel_ = 0;              // ,     
+    size_t blockPos_ = 0;                 //     
+    size_t blockPick_ = 0;                //     
+};
+
+/// <summary>
+///    :      ,   .
+/// </summary>
+/// <typeparam name="Policy"> .</typeparam>
+/// <typeparam name="T">   (int, float)</typeparam>
+/// <param name="arr">,    .</param>
+/// <param name="numThreads"> .</param>
+/// <param name="k">   (. sketchKForError).</param>
+/// <returns>  .</returns>
+template <typename Policy, typename T>
+KllSketch<T> buildQuantileSketch(const std::vector<T>& arr, size_t numThreads, size_t k = defaultSketchK) {
+    numThreads = std::max<size_t>(1, std::min({ numThreads, arr.size(), sortTuning.maxThreads }));
+    std::vector<KllSketch<T>> partial;
+    for (size_t i = 0; i < numThreads; ++i) {
+        partial.emplace_back(k, static_cast<uint32_t>(i + 1));
+    }
+    size_t blockSize = (arr.size() + numThreads - 1) / numThreads;
+    ExecutionBackend<Policy>::parallelFor(numThreads, numThreads, [&](size_t first, size_t last) {
+        for (size_t part = first; part < last; ++part) {
+            size_t left = std::min(part * blockSize, arr.size());
+            size_t right = std::min(left + blockSize, arr.size());
+            partial[part].update(arr.data() + left, right - left);
+        }
+    });
+    for (size_t i = 1; i < partial.size(); ++i) {
+        partial[0].merge(partial[i]);
+    }
+    return std::move(partial[0]);
+}
+
+/// <summary>
+///      .    q   
+///    [quantile(q - 2e), quantile(q + 2e)]:    
+///        ,  nth_element  
+///   .        ,     .
+/// </summary>
+/// <typeparam name="Policy"> .</typeparam>
+/// <typeparam name="T">   (int, float)</typeparam>
+/// <param name="arr">.</param>
+/// <param name="qs">  0  1;   q -    floor(q * (n - 1))   .</param>
+/// <param name="sketch">  arr.</param>
+/// <param name="numThreads"> .</param>
+/// <returns>    qs.</returns>
+template <typename Policy, typename T>
+std::vector<T> exactQuantiles(const std::vector<T>& arr, const std::vector<double>& qs, const KllSketch<T>& sketch, size_t numThreads) {
+    if (arr.empty()) return std::vector<T>(qs.size());
+    size_t windowCount = qs.size();
+    std::vector<size_t> targets(windowCount);
+    std::vector<double> boundQs;
+    double margin = 2 * sketch.rankError();
+    for (size_t w = 0; w < windowCount; ++w) {
+        double q = std::clamp(qs[w], 0.0, 1.0);
+        targets[w] = static_cast<size_t>(q * static_cast<double>(arr.size() - 1));
+        boundQs.push_back(q - margin);
+        boundQs.push_back(q + margin);
+    }
+    std::vector<T> bounds = sketch.quantiles(boundQs);
+
+    //          
+    numThreads = std::max<size_t>(1, std::min({ numThreads, arr.size(), sortTuning.maxThreads }));
+    size_t blockSize = (arr.size() + numThreads - 1) / numThreads;
+    std::vector<std::vector<size_t>> below(numThreads, std::vector<size_t>(windowCount, 0));
+    std::vector<std::vector<std::vector<T>>> windows(numThreads, std::vector<std::vector<T>>(windowCount));
+    ExecutionBackend<Policy>::parallelFor(numThreads, numThreads, [&](size_t first, size_t last) {
+        for (size_t part = first; part < last; ++part) {
+            size_t left = std::min(part * blockSize, arr.size());
+            size_t right = std::min(left + blockSize, arr.size());
+            std::vector<size_t>& count = below[part];
+            std::vector<T> tile(quantileScanTile);
+            //     ,     
+            for (size_t start = left; start < right; start += quantileScanTile) {
+                size_t end = std::min(start + quantileScanTile, right);
+                for (size_t w = 0; w < windowCount; ++w) {
+                    T low = bounds[2 * w], high = bounds[2 * w + 1];
+                    size_t under = 0, kept = 0;
+                    //  :   ,       
+                    for (size_t i = start; i < end; ++i) {
+                        T x = arr[i];
+                        bool isBelow = x < low;
+                        bool isAbove = high < x;
+                        under += isBelow;
+                        tile[kept] = x;
+                        kept += !(isBelow | isAbove);
+                    }
+                    count[w] += under;
+                    windows[part][w].insert(windows[part][w].end(), tile.begin(), tile.begin() + kept);
+                }
+            }
+        }
+    });
+
+    std::vector<T> result(windowCount);
+    for (size_t w = 0; w < windowCount; ++w) {
+        size_t belowTotal = 0;
+        std::vector<T> candidates;
+        for (size_t part = 0; part < numThreads; ++part) {
+            belowTotal += below[part][w];
+            candidates.insert(candidates.end(), windows[part][w].begin(), windows[part][w].end());
+        }
+        if (targets[w] >= belowTotal && targets[w] - belowTotal < candidates.size()) {
+            auto nth = candidates.begin() + (targets[w] - belowTotal);
+            std::nth_element(candidates.begin(), nth, candidates.end());
+            result[w] = *nth;
+        }
+        else {
+            //    :     
+            std::vector<T> copy = arr;
+            std::nth_element(copy.begin(), copy.begin() + targets[w], copy.end());
+            result[w] = copy[targets[w]];
+        }
+    }
+    return result;
+}
+
+/// <summary>
+///     (. exactQuantiles).
+/// </summary>
+template <typename Policy, typename T>
+T exactQuantile(const std::vector<T>& arr, double q, const KllSketch<T>& sketch, size_t numThreads) {
+    return exactQuantiles<Policy>(arr, { q }, sketch, numThreads).front();
+}
+
+/// <summary>
+///         policyMergeSort.
+/// </summary>
+/// <param name="numThreads"> .</param>
+/// <param name="size"> .</param>
+inline void compareQuantiles(size_t numThreads, size_t size = 60000000) {
+    std::vector<float> input = generateRandomArray<float, ThreadPolicy>(size, numThreads);
+    std::vector<double> qs = { 0.5, 0.9, 0.99, 0.999 };
+    std::cout << "Quantiles of " << size << " elements, Threads: " << numThreads << "\n";
+
+    std::vector<float> sorted = input;
+    auto start = std::chrono::high_resolution_clock::now();
+    policyMergeSort<ThreadPolicy>(sorted, numThreads);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "  policyMergeSort: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    KllSketch<float> sketch = buildQuantileSketch<ThreadPolicy>(input, numThreads);
+    std::vector<float> approx = sketch.quantiles(qs);
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "  sketch (k = " << sketch.k() << ", rank error " << sketch.rankError() << "): "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    std::vector<float> exact = exactQuantiles<ThreadPolicy>(input, qs, sketch, numThreads);
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "  exact from sketch: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms\n";
+
+    for (size_t i = 0; i < qs.size(); ++i) {
+        float reference = sorted[static_cast<size_t>(qs[i] * (size - 1))];
+        std::cout << "  q = " << qs[i] << ": approx " << approx[i] << ", exact " << exact[i]
+            << (exact[i] == reference ? "" : " WRONG RESULT") << "\n";
+    }
+}
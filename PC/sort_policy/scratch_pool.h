@@ -0,0 +1,349 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <new>
+#include <string>
+#include <type_traits>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define SCRATCH_POOL_HAS_MMAP 1
+#else
+#define SCRATCH_POOL_HAS_MMAP 0
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#define SCRATCH_POOL_HAS_RUSAGE 1
+#else
+#define SCRATCH_POOL_HAS_RUSAGE 0
+#endif
+
+///    (2 ),     
+constexpr size_t hugePageSize = size_t(2) << 20;
+
+///  ,     ,      
+constexpr size_t scratchMaxIdleAcquires = 64;
+
+///    ,           ...
+constexpr size_t scratchMemoryCheckBytes = size_t(64) << 20;
+
+/// ...    
+constexpr size_t scratchMemoryCheckReleases = 256;
+
+/// <summary>
+///    .
+/// </summary>
+struct PageFaults {
+    long long minor = 0; //     (       )
+    long long major = 0; //    
+};
+
+/// <summary>
+///         (,     ).
+/// </summary>
+inline PageFaults currentPageFaults() {
+    PageFaults faults;
+#if SCRATCH_POOL_HAS_RUSAGE
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+        faults.minor = usage.ru_minflt;
+        faults.major = usage.ru_majflt;
+    }
+#endif
+    return faults;
+}
+
+/// <summary>
+///    .
+/// </summary>
+struct ScratchPoolStats {
+    size_t mappedBytes = 0;  //    
+    size_t cachedBytes = 0;  //     
+    size_t acquires = 0;     //  
+    size_t reuses = 0;       //      
+    size_t trimmedBytes = 0; //  
+};
+
+/// <summary>
+///      .
+///    2    Linux   madvise(MADV_HUGEPAGE) (  )
+/// ,  ,     (MAP_HUGETLB).     
+///          .    
+/// ,           .
+/// </summary>
+class ScratchPool {
+public:
+    /// <summary>
+    ///   .
+    /// </summary>
+    static ScratchPool& instance() {
+        static ScratchPool pool;
+        return pool;
+    }
+
+    ~ScratchPool() {
+        trim(0);
+    }
+
+    ScratchPool(const ScratchPool&) = delete;
+    ScratchPool& operator=(const ScratchPool&) = delete;
+
+    /// <summary>
+    ///      bytes ,   4096.
+    ///    ,        .
+    ///        ,     
+    ///    -      .
+    /// </summary>
+    void* acquire(size_t bytes) {
+        size_t capacity = roundUp(std::max<size_t>(bytes, 1));
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.acquires;
+
+        auto it = free_.lower_bound(capacity);
+        if (it != free_.end() && it->first <= 2 * capacity) {
+            Block block = it->second;
+            free_.erase(it);
+            stats_.cachedBytes -= block.capacity;
+            ++stats_.reuses;
+            used_.emplace(block.data, block);
+            return block.data;
+        }
+
+        // ,       ,     
+        for (auto entry = free_.begin(); entry != free_.end();) {
+            if (stats_.acquires - entry->second.releasedAt > scratchMaxIdleAcquires) {
+                entry = eraseFree(entry);
+            }
+            else {
+                ++entry;
+            }
+        }
+        //         :    
+        while (!free_.empty() && stats_.cachedBytes + capacity > cacheLimit_) {
+            auto oldest = std::min_element(free_.begin(), free_.end(), [](const auto& a, const auto& b) {
+                return a.second.releasedAt < b.second.releasedAt;
+            });
+            eraseFree(oldest);
+        }
+
+        Block block = mapBlock(capacity);
+        used_.emplace(block.data, block);
+        return block.data;
+    }
+
+    /// <summary>
+    ///    .
+    /// </summary>
+    void release(void* data) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = used_.find(data);
+        if (it == used_.end()) return;
+        Block block = it->second;
+        block.releasedAt = stats_.acquires;
+        used_.erase(it);
+        free_.emplace(block.capacity, block);
+        stats_.cachedBytes += block.capacity;
+
+        // /proc/meminfo     ,         .
+        //    :    
+        size_t limit = cacheLimit_;
+        checkedBytes_ = std::min(checkedBytes_, stats_.cachedBytes);
+        if (stats_.cachedBytes >= checkedBytes_ + scratchMemoryCheckBytes || ++releasesSinceCheck_ >= scratchMemoryCheckReleases) {
+            if (availableMemory() < 2 * stats_.cachedBytes) limit = 0;
+            releasesSinceCheck_ = 0;
+            trimLocked(limit);
+            checkedBytes_ = stats_.cachedBytes;
+            return;
+        }
+        trimLocked(limit);
+    }
+
+    /// <summary>
+    ///    ,      keepBytes  (  ).
+    /// </summary>
+    void trim(size_t keepBytes = 0) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        trimLocked(keepBytes);
+    }
+
+    /// <summary>
+    ///      (  1/8  ).
+    /// </summary>
+    void setCacheLimit(size_t bytes) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cacheLimit_ = bytes;
+        trimLocked(cacheLimit_);
+    }
+
+    /// <summary>
+    ///       (MAP_HUGETLB, vm.nr_hugepages).
+    ///    ,     madvise(MADV_HUGEPAGE).
+    /// </summary>
+    void setExplicitHugePages(bool enable) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        explicitHugePages_ = enable;
+    }
+
+    ScratchPoolStats stats() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+private:
+    ///  : base  mapped -  , data  capacity -  
+    struct Block {
+        void* base = nullptr;
+        size_t mapped = 0;
+        void* data = nullptr;
+        size_t capacity = 0;
+        size_t releasedAt = 0; //  stats_.acquires    
+    };
+
+    ScratchPool() {
+#if SCRATCH_POOL_HAS_MMAP
+        long pages = sysconf(_SC_PHYS_PAGES);
+        long pageSize = sysconf(_SC_PAGESIZE);
+        if (pages > 0 && pageSize > 0) cacheLimit_ = static_cast<size_t>(pages) * static_cast<size_t>(pageSize) / 8;
+#endif
+    }
+
+    static size_t roundUp(size_t bytes) {
+        return (bytes + hugePageSize - 1) / hugePageSize * hugePageSize;
+    }
+
+    /// <summary>
+    ///    (MemAvailable);  /proc/meminfo -  .
+    /// </summary>
+    static size_t availableMemory() {
+#if SCRATCH_POOL_HAS_MMAP
+        std::ifstream meminfo("/proc/meminfo");
+        std::string key;
+        size_t value;
+        std::string unit;
+        while (meminfo >> key >> value >> unit) {
+            if (key == "MemAvailable:") return value * 1024;
+        }
+#endif
+        return SIZE_MAX / 2;
+    }
+
+    Block mapBlock(size_t capacity) {
+        Block block;
+        block.capacity = capacity;
+#if SCRATCH_POOL_HAS_MMAP
+#ifdef MAP_HUGETLB
+        if (explicitHugePages_) {
+            void* p = mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (p != MAP_FAILED) {
+                block.base = block.data = p;
+                block.mapped = capacity;
+                stats_.mappedBytes += capacity;
+                return block;
+            }
+        }
+#endif
+        //  2       ,    
+        size_t mapped = capacity + hugePageSize;
+        void* p = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) throw std::bad_alloc();
+        uintptr_t start = reinterpret_cast<uintptr_t>(p);
+        uintptr_t aligned = (start + hugePageSize - 1) / hugePageSize * hugePageSize;
+        if (aligned > start) munmap(p, aligned - start);
+        size_t tail = (start + mapped) - (aligned + capacity);
+        if (tail > 0) munmap(reinterpret_cast<void*>(aligned + capacity), tail);
+        block.base = block.data = reinterpret_cast<void*>(aligned);
+        block.mapped = capacity;
+#ifdef MADV_HUGEPAGE
+        madvise(block.data, capacity, MADV_HUGEPAGE);
+#endif
+#else
+        block.base = block.data = ::operator new(capacity, std::align_val_t(4096));
+        block.mapped = capacity;
+#endif
+        stats_.mappedBytes += block.mapped;
+        return block;
+    }
+
+    void unmapBlock(const Block& block) {
+#if SCRATCH_POOL_HAS_MMAP
+        munmap(block.base, block.mapped);
+#else
+        ::operator delete(block.base, std::align_val_t(4096));
+#endif
+        stats_.mappedBytes -= block.mapped;
+        stats_.trimmedBytes += block.mapped;
+    }
+
+    std::multimap<size_t, Block>::iterator eraseFree(std::multimap<size_t, Block>::iterator entry) {
+        unmapBlock(entry->second);
+        stats_.cachedBytes -= entry->first;
+        return free_.erase(entry);
+    }
+
+    void trimLocked(size_t keepBytes) {
+        while (stats_.cachedBytes > keepBytes && !free_.empty()) {
+            eraseFree(std::prev(free_.end()));
+        }
+    }
+
+    std::multimap<size_t, Block> free_; //    
+    std::map<void*, Block> used_;       //    
+    mutable std::mutex mutex_;
+    size_t cacheLimit_ = size_t(1) << 30;
+    size_t checkedBytes_ = 0;       //        
+    size_t releasesSinceCheck_ = 0; //    
+    bool explicitHugePages_ = false;
+    ScratchPoolStats stats_;
+};
+
+/// <summary>
+///     ScratchPool:    std::vector&lt;T&gt;(n)  
+///         .      .
+/// </summary>
+/// <typeparam name="T">  (int, float)</typeparam>
+template <typename T>
+class ScratchBuffer {
+    static_assert(std::is_trivially_copyable_v<T> && std::is_trivially_default_constructible_v<T>,
+        "ScratchBuffer holds uninitialized memory and needs a trivial type");
+
+public:
+    explicit ScratchBuffer(size_t size = 0)
+        : data_(size ? static_cast<T*>(ScratchPool::instance().acquire(size * sizeof(T))) : nullptr), size_(size) {}
+
+    ~ScratchBuffer() {
+        if (data_) ScratchPool::instance().release(data_);
+    }
+
+    ScratchBuffer(const ScratchBuffer&) = delete;
+    ScratchBuffer& operator=(const ScratchBuffer&) = delete;
+
+    ScratchBuffer(ScratchBuffer&& other) noexcept : data_(other.data_), size_(other.size_) {
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+
+    ScratchBuffer& operator=(ScratchBuffer&& other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        return *this;
+    }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    size_t size() const { return size_; }
+    T& operator[](size_t i) { return data_[i]; }
+    const T& operator[](size_t i) const { return data_[i]; }
+    T* begin() { return data_; }
+    T* end() { return data_ + size_; }
+
+private:
+    T* data_;
+    size_t size_;
+};
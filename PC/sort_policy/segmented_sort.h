@@ -0,0 +1,258 @@
+#pragma once
+#include <vector>
+#include <array>
+#include <atomic>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include "lib.h"
+
+///  ,   
+constexpr size_t segmentNetworkSize = 16;
+
+///      :  ,   
+constexpr size_t segmentBatchesPerThread = 16;
+
+/// <summary>
+///  :  ,       .
+/// </summary>
+struct SortingNetwork {
+    std::array<uint8_t, 64> low{};  // ,   
+    std::array<uint8_t, 64> high{}; // ,   
+    size_t count = 0;               //  
+};
+
+/// <summary>
+///   -    n .
+///   16  :      n ,
+///       .
+/// </summary>
+/// <param name="n">  (  segmentNetworkSize).</param>
+/// <returns> .</returns>
+constexpr SortingNetwork makeSortingNetwork(size_t n) {
+    SortingNetwork network;
+    for (size_t p = 1; p < segmentNetworkSize; p *= 2) {
+        for (size_t k = p; k >= 1; k /= 2) {
+            for (size_t j = k % p; j + k < segmentNetworkSize; j += 2 * k) {
+                for (size_t i = 0; i < k && i + j + k < segmentNetworkSize; ++i) {
+                    //         2p
+                    if ((i + j) / (2 * p) == (i + j + k) / (2 * p) && i + j + k < n) {
+                        network.low[network.count] = static_cast<uint8_t>(i + j);
+                        network.high[network.count] = static_cast<uint8_t>(i + j + k);
+                        ++network.count;
+                    }
+                }
+            }
+        }
+    }
+    return network;
+}
+
+/// <summary>
+///     N .      
+///     min/max  .
+/// </summary>
+template <size_t N, typename T, size_t... I>
+void applySortingNetwork(T* a, std::index_sequence<I...>) {
+    constexpr SortingNetwork network = makeSortingNetwork(N);
+    auto compareExchange = [a](size_t i, size_t j) {
+        T x = a[i], y = a[j];
+        a[i] = std::min(x, y);
+        a[j] = std::max(x, y);
+    };
+    (compareExchange(network.low[I], network.high[I]), ...);
+}
+
+/// <summary>
+///  N   .
+/// </summary>
+template <size_t N, typename T>
+void sortingNetworkSort(T* a) {
+    applySortingNetwork<N>(a, std::make_index_sequence<makeSortingNetwork(N).count>{});
+}
+
+/// <summary>
+///    segmentNetworkSize     .
+/// </summary>
+/// <typeparam name="T">   (int, float)</typeparam>
+/// <param name="a"> .</param>
+/// <param name="n"> .</param>
+template <typename T>
+void sortTinySegment(T* a, size_t n) {
+    switch (n) {
+    case 2: sortingNetworkSort<2>(a); break;
+    case 3: sortingNetworkSort<3>(a); break;
+    case 4: sortingNetworkSort<4>(a); break;
+    case 5: sortingNetworkSort<5>(a); break;
+    case 6: sortingNetworkSort<6>(a); break;
+    case 7: sortingNetworkSort<7>(a); break;
+    case 8: sortingNetworkSort<8>(a); break;
+    case 9: sortingNetworkSort<9>(a); break;
+    case 10: sortingNetworkSort<10>(a); break;
+    case 11: sortingNetworkSort<11>(a); break;
+    case 12: sortingNetworkSort<12>(a); break;
+    case 13: sortingNetworkSort<13>(a); break;
+    case 14: sortingNetworkSort<14>(a); break;
+    case 15: sortingNetworkSort<15>(a); break;
+    case 16: sortingNetworkSort<16>(a); break;
+    default: break; //      
+    }
+}
+
+/// <summary>
+///    :   segmentNetworkSize  
+///  ,        scratch.
+/// </summary>
+/// <typeparam name="T">   (int, float)</typeparam>
+/// <param name="a"> .</param>
+/// <param name="n"> .</param>
+/// <param name="scratch">   .</param>
+template <typename T>
+void sortMediumSegment(T* a, size_t n, T* scratch) {
+    for (size_t i = 0; i < n; i += segmentNetworkSize) {
+        sortTinySegment(a + i, std::min(segmentNetworkSize, n - i));
+    }
+    //         
+    T* src = a;
+    T* dst = scratch;
+    for (size_t width = segmentNetworkSize; width < n; width *= 2) {
+        for (size_t left = 0; left < n; left += 2 * width) {
+            size_t mid = std::min(left + width, n);
+            size_t right = std::min(left + 2 * width, n);
+            mergeSortedRanges(src + left, mid - left, src + mid, right - mid, dst + left);
+        }
+        std::swap(src, dst);
+    }
+    if (src != a) {
+        std::memcpy(a, src, n * sizeof(T));
+    }
+}
+
+/// <summary>
+///         .
+///  i  [offsets[i], offsets[i + 1]).
+///     ,  -  ;
+///           .
+///            policyMergeSortRange.
+/// </summary>
+/// <typeparam name="Policy"> .</typeparam>
+/// <typeparam name="T">   (int, float)</typeparam>
+/// <param name="values">,   .</param>
+/// <param name="offsets">  ,   values.size().</param>
+/// <param name="numThreads"> .</param>
+/// <returns>false,    ;      .</returns>
+template <typename Policy, typename T>
+bool segmentedSort(std::vector<T>& values, const std::vector<size_t>& offsets, size_t numThreads) {
+    if (offsets.size() < 2) return true; //    
+    for (size_t i = 1; i < offsets.size(); ++i) {
+        if (offsets[i] < offsets[i - 1]) return false;
+    }
+    if (offsets.back() > values.size()) return false;
+
+    size_t segments = offsets.size() - 1;
+    size_t total = offsets.back() - offsets.front();
+    numThreads = std::max<size_t>(1, std::min(numThreads, sortTuning.maxThreads));
+    //   ,      
+    size_t largeSize = numThreads > 1 ? std::max(sortTuning.mergeGrain, total / numThreads) : SIZE_MAX;
+    auto isLarge = [&](size_t segment) { return offsets[segment + 1] - offsets[segment] >= largeSize; };
+    //     n: n * log2(n)
+    auto segmentCost = [](size_t n) {
+        size_t log = 1;
+        while ((size_t(1) << log) < n) ++log;
+        return n * log;
+    };
+
+    //            
+    size_t totalCost = 0;
+    size_t maxMedium = 0;
+    for (size_t i = 0; i < segments; ++i) {
+        if (!isLarge(i)) {
+            size_t n = offsets[i + 1] - offsets[i];
+            totalCost += segmentCost(n);
+            maxMedium = std::max(maxMedium, n);
+        }
+    }
+    size_t batchCost = std::max<size_t>(1, totalCost / (numThreads * segmentBatchesPerThread));
+    std::vector<size_t> batches = { 0 }; //  b   [batches[b], batches[b + 1])
+    size_t cost = 0;
+    for (size_t i = 0; i < segments; ++i) {
+        if (!isLarge(i)) {
+            cost += segmentCost(offsets[i + 1] - offsets[i]);
+        }
+        if (cost >= batchCost) {
+            batches.push_back(i + 1);
+            cost = 0;
+        }
+    }
+    if (batches.back() != segments) {
+        batches.push_back(segments);
+    }
+
+    //      ,    
+    std::atomic<size_t> nextBatch{ 0 };
+    ExecutionBackend<Policy>::parallelFor(numThreads, numThreads, [&](size_t, size_t) {
+        ScratchBuffer<T> scratch(maxMedium > segmentNetworkSize ? maxMedium : 0);
+        for (size_t b = nextBatch++; b + 1 < batches.size(); b = nextBatch++) {
+            for (size_t i = batches[b]; i < batches[b + 1]; ++i) {
+                if (isLarge(i)) continue;
+                size_t n = offsets[i + 1] - offsets[i];
+                if (n <= segmentNetworkSize) {
+                    sortTinySegment(values.data() + offsets[i], n);
+                }
+                else {
+                    sortMediumSegment(values.data() + offsets[i], n, scratch.data());
+                }
+            }
+        }
+    });
+
+    //     ,   
+    ScratchBuffer<T> temp;
+    for (size_t i = 0; i < segments; ++i) {
+        if (isLarge(i)) {
+            if (temp.size() == 0) {
+                temp = ScratchBuffer<T>(values.size());
+            }
+            policyMergeSortRange<Policy>(values, offsets[i], offsets[i + 1], temp, numThreads);
+        }
+    }
+    return true;
+}
+
+/// <summary>
+///  segmentedSort       policyMergeSort.
+/// </summary>
+/// <param name="numThreads"> .</param>
+/// <param name="segments">    10  1000 .</param>
+inline void compareSegmentedSort(size_t numThreads, size_t segments = 20000) {
+    std::mt19937 gen(12345);
+    std::uniform_int_distribution<size_t> lengths(10, 1000);
+    std::vector<size_t> offsets = { 0 };
+    for (size_t i = 0; i < segments; ++i) {
+        offsets.push_back(offsets.back() + lengths(gen));
+    }
+    std::vector<int> input = generateRandomArray<int, ThreadPolicy>(offsets.back(), numThreads);
+    std::cout << "Segments: " << segments << ", elements: " << offsets.back() << ", Threads: " << numThreads << "\n";
+
+    //     
+    std::vector<int> reference = input;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < segments; ++i) {
+        std::vector<int> segment(reference.begin() + offsets[i], reference.begin() + offsets[i + 1]);
+        policyMergeSort<ThreadPolicy>(segment, numThreads);
+        std::copy(segment.begin(), segment.end(), reference.begin() + offsets[i]);
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "  policyMergeSort per segment: "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms\n";
+
+    //     
+    std::vector<int> arr = input;
+    start = std::chrono::high_resolution_clock::now();
+    segmentedSort<ThreadPolicy>(arr, offsets, numThreads);
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "  segmentedSort: "
+        << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms"
+        << (arr == reference ? "" : " WRONG RESULT") << "\n";
+}
@@ -0,0 +1,195 @@
+#pragma once
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include "lib.h"
+#include "segmented_sort.h"
+
+///       
+constexpr size_t sampleSortBucketsPerThread = 4;
+
+///      
+constexpr size_t sampleSortOversampling = 32;
+
+/// <summary>
+///       ,   T.
+/// </summary>
+template <typename T>
+using RadixKey = std::conditional_t<(sizeof(T) > 4), uint64_t, uint32_t>;
+
+/// <summary>
+///         :     
+///  ,         .
+/// </summary>
+/// <typeparam name="T">   (int, float)</typeparam>
+template <typename T>
+RadixKey<T> toRadixKey(T value) {
+    using Key = RadixKey<T>;
+    constexpr Key signBit = Key(1) << (8 * sizeof(T) - 1);
+    if constexpr (std::is_floating_point_v<T>) {
+        static_assert(sizeof(T) == sizeof(Key), "Radix sort supports float and double");
+        Key bits;
+        std::memcpy(&bits, &value, sizeof(T));
+        return (bits & signBit) ? ~bits : (bits | signBit);
+    }
+    else {
+        Key key = static_cast<Key>(static_cast<std::make_unsigned_t<T>>(value));
+        if constexpr (std::is_signed_v<T>) {
+            key ^= signBit;
+        }
+        return key;
+    }
+}
+
+/// <summary>
+///     (LSD,   8 ).
+///           
+///   ,   . ,   
+///  (,    ), .
+/// </summary>
+/// <typeparam name="Policy"> .</typeparam>
+/// <typeparam name="T">   (int, float)</typeparam>
+/// <param name="arr">  .</param>
+/// <param name="numThreads"> .</param>
+template <typename Policy, typename T>
+void radixSort(std::vector<T>& arr, size_t numThreads) {
+    static_assert(std::is_arithmetic_v<T>, "Radix sort needs a numeric type");
+    size_t n = arr.size();
+    if (n < 2) return;
+    numThreads = std::max<size_t>(1, std::min({ numThreads, n, sortTuning.maxThreads }));
+    constexpr size_t passes = sizeof(T);
+    size_t blockSize = (n + numThreads - 1) / numThreads;
+
+    //       
+    std::vector<std::vector<size_t>> blockCounts(numThreads, std::vector<size_t>(passes * 256, 0));
+    ExecutionBackend<Policy>::parallelFor(numThreads, numThreads, [&](size_t first, size_t last) {
+        for (size_t block = first; block < last; ++block) {
+            size_t* counts = blockCounts[block].data();
+            for (size_t i = block * blockSize; i < std::min(n, (block + 1) * blockSize); ++i) {
+                RadixKey<T> key = toRadixKey(arr[i]);
+                for (size_t pass = 0; pass < passes; ++pass) {
+                    ++counts[pass * 256 + ((key >> (8 * pass)) & 0xFF)];
+                }
+            }
+        }
+    });
+
+    ScratchBuffer<T> temp(n);
+    T* src = arr.data();
+    T* dst = temp.data();
+    for (size_t pass = 0; pass < passes; ++pass) {
+        //  ,      
+        bool trivial = false;
+        for (size_t digit = 0; digit < 256 && !trivial; ++digit) {
+            size_t total = 0;
+            for (size_t block = 0; block < numThreads; ++block) total += blockCounts[block][pass * 256 + digit];
+            trivial = total == n;
+        }
+        if (trivial) continue;
+
+        //       
+        std::vector<std::vector<size_t>> offsets(numThreads, std::vector<size_t>(256, 0));
+        ExecutionBackend<Policy>::parallelFor(numThreads, numThreads, [&](size_t first, size_t last) {
+            for (size_t block = first; block < last; ++block) {
+                for (size_t i = block * blockSize; i < std::min(n, (block + 1) * blockSize); ++i) {
+                    ++offsets[block][(toRadixKey(src[i]) >> (8 * pass)) & 0xFF];
+                }
+            }
+        });
+        // :   ,   -   
+        size_t position = 0;
+        for (size_t digit = 0; digit < 256; ++digit) {
+            for (size_t block = 0; block < numThreads; ++block) {
+                size_t count = offsets[block][digit];
+                offsets[block][digit] = position;
+                position += count;
+            }
+        }
+        //     
+        ExecutionBackend<Policy>::parallelFor(numThreads, numThreads, [&](size_t first, size_t last) {
+            for (size_t block = first; block < last; ++block) {
+                size_t* next = offsets[block].data();
+                for (size_t i = block * blockSize; i < std::min(n, (block + 1) * blockSize); ++i) {
+                    dst[next[(toRadixKey(src[i]) >> (8 * pass)) & 0xFF]++] = src[i];
+                }
+            }
+        });
+        std::swap(src, dst);
+    }
+    //   ,      
+    if (src != arr.data()) {
+        ExecutionBackend<Policy>::parallelFor(n, numThreads, [&](size_t first, size_t last) {
+            std::memcpy(arr.data() + first, src + first, (last - first) * sizeof(T));
+        });
+    }
+}
+
+/// <summary>
+///    :    
+///  ,         ,
+///      segmentedSort.
+/// </summary>
+/// <typeparam name="Policy"> .</typeparam>
+/// <typeparam name="T">   (int, float)</typeparam>
+/// <param name="arr">  .</param>
+/// <param name="numThreads"> .</param>
+template <typename Policy, typename T>
+void sampleSort(std::vector<T>& arr, size_t numThreads) {
+    size_t n = arr.size();
+    if (n < 2) return;
+    numThreads = std::max<size_t>(1, std::min({ numThreads, n, sortTuning.maxThreads }));
+    size_t buckets = std::min<size_t>(256, numThreads * sampleSortBucketsPerThread);
+    size_t blockSize = (n + numThreads - 1) / numThreads;
+
+    //      
+    std::mt19937 gen(static_cast<uint32_t>(n));
+    std::uniform_int_distribution<size_t> pick(0, n - 1);
+    std::vector<T> sample(buckets * sampleSortOversampling);
+    for (T& value : sample) value = arr[pick(gen)];
+    std::sort(sample.begin(), sample.end());
+    std::vector<T> splitters;
+    for (size_t b = 1; b < buckets; ++b) {
+        splitters.push_back(sample[b * sampleSortOversampling]);
+    }
+
+    //           
+    ScratchBuffer<uint8_t> bucketOf(n);
+    std::vector<std::vector<size_t>> offsets(numThreads, std::vector<size_t>(buckets, 0));
+    ExecutionBackend<Policy>::parallelFor(numThreads, numThreads, [&](size_t first, size_t last) {
+        for (size_t block = first; block < last; ++block) {
+            for (size_t i = block * blockSize; i < std::min(n, (block + 1) * blockSize); ++i) {
+                size_t bucket = std::upper_bound(splitters.begin(), splitters.end(), arr[i]) - splitters.begin();
+                bucketOf[i] = static_cast<uint8_t>(bucket);
+                ++offsets[block][bucket];
+            }
+        }
+    });
+    std::vector<size_t> bounds = { 0 };
+    size_t position = 0;
+    for (size_t bucket = 0; bucket < buckets; ++bucket) {
+        for (size_t block = 0; block < numThreads; ++block) {
+            size_t count = offsets[block][bucket];
+            offsets[block][bucket] = position;
+            position += count;
+        }
+        bounds.push_back(position);
+    }
+
+    //          
+    ScratchBuffer<T> temp(n);
+    ExecutionBackend<Policy>::parallelFor(numThreads, numThreads, [&](size_t first, size_t last) {
+        for (size_t block = first; block < last; ++block) {
+            size_t* next = offsets[block].data();
+            for (size_t i = block * blockSize; i < std::min(n, (block + 1) * blockSize); ++i) {
+                temp[next[bucketOf[i]]++] = arr[i];
+            }
+        }
+    });
+    ExecutionBackend<Policy>::parallelFor(n, numThreads, [&](size_t first, size_t last) {
+        std::memcpy(arr.data() + first, temp.data() + first, (last - first) * sizeof(T));
+    });
+    segmentedSort<Policy>(arr, bounds, numThreads);
+}
@@ -0,0 +1,163 @@
+#pragma once
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <utility>
+#include "lib.h"
+
+///        
+constexpr size_t defaultStreamBlockSize = 65536;
+
+/// <summary>
+///   :     ,   
+///       k-     .
+///    ,     .
+/// </summary>
+/// <typeparam name="T">   (int, float)</typeparam>
+template <typename T>
+class SortedStream {
+public:
+    /// <summary>
+    ///    ,   [bounds[i], bounds[i + 1])  .
+    /// </summary>
+    SortedStream(std::vector<T> data, const std::vector<size_t>& bounds, size_t blockSize)
+        : data_(std::move(data)), blockSize_(std::max<size_t>(1, blockSize)) {
+        for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+            if (bounds[i] < bounds[i + 1]) {
+                ends_.push_back(bounds[i + 1]);
+                heap_.push_back({ data_[bounds[i]], ends_.size() - 1 });
+                positions_.push_back(bounds[i]);
+            }
+        }
+        std::make_heap(heap_.begin(), heap_.end(), std::greater<>());
+    }
+
+    /// <summary>
+    ///   block    ,    .
+    /// </summary>
+    /// <param name="block"> ;   .</param>
+    /// <returns>false,     .</returns>
+    bool next(std::vector<T>& block) {
+        block.clear();
+        if (heap_.empty()) return false;
+        block.reserve(blockSize_);
+        while (block.size() < blockSize_ && !heap_.empty()) {
+            if (heap_.size() == 1) {
+                //   :    
+                size_t part = heap_.front().second;
+                size_t take = std::min(blockSize_ - block.size(), ends_[part] - positions_[part]);
+                block.insert(block.end(), data_.begin() + positions_[part], data_.begin() + positions_[part] + take);
+                positions_[part] += take;
+                if (positions_[part] == ends_[part]) {
+                    heap_.clear();
+                }
+                else {
+                    heap_.front().first = data_[positions_[part]];
+                }
+                break;
+            }
+            //     ;    -    
+            std::pop_heap(heap_.begin(), heap_.end(), std::greater<>());
+            size_t part = heap_.back().second;
+            T limit = heap_.front().first;
+            size_t& pos = positions_[part];
+            //   ,       
+            do {
+                block.push_back(data_[pos]);
+                ++pos;
+            } while (pos < ends_[part] && block.size() < blockSize_ && !(limit < data_[pos]));
+            if (pos < ends_[part]) {
+                heap_.back().first = data_[pos];
+                std::push_heap(heap_.begin(), heap_.end(), std::greater<>());
+            }
+            else {
+                heap_.pop_back();
+            }
+        }
+        emitted_ += block.size();
+        return true;
+    }
+
+    /// <summary>
+    ///     .
+    /// </summary>
+    size_t remaining() const { return data_.size() - emitted_; }
+
+    /// <summary>
+    ///   .
+    /// </summary>
+    size_t parts() const { return ends_.size(); }
+
+private:
+    std::vector<T> data_;                       //    
+    std::vector<size_t> positions_;             //     
+    std::vector<size_t> ends_;                  //   
+    std::vector<std::pair<T, size_t>> heap_;    //   :    
+    size_t blockSize_;
+    size_t emitted_ = 0;
+};
+
+/// <summary>
+///    :       ,
+///   ,      .
+/// </summary>
+/// <typeparam name="Policy"> .</typeparam>
+/// <typeparam name="T">   (int, float)</typeparam>
+/// <param name="arr">;    .</param>
+/// <param name="numThreads"> .</param>
+/// <param name="blockSize">    .</param>
+/// <returns>  .</returns>
+template <typename Policy, typename T>
+SortedStream<T> makeSortedStream(std::vector<T> arr, size_t numThreads, size_t blockSize = defaultStreamBlockSize) {
+    size_t n = arr.size();
+    numThreads = std::max<size_t>(1, std::min({ numThreads, n, sortTuning.maxThreads }));
+    size_t chunkSize = n == 0 ? 0 : (n + numThreads - 1) / numThreads;
+    std::vector<size_t> bounds;
+    for (size_t i = 0; i <= numThreads; ++i) {
+        bounds.push_back(std::min(i * chunkSize, n));
+    }
+    if (n > 0) {
+        //     ;      
+        ScratchBuffer<T> temp(n);
+        ExecutionBackend<Policy>::parallelFor(numThreads, numThreads, [&](size_t first, size_t last) {
+            for (size_t chunk = first; chunk < last; ++chunk) {
+                if (bounds[chunk] < bounds[chunk + 1]) {
+                    mergeSort(arr, bounds[chunk], bounds[chunk + 1] - 1, temp);
+                }
+            }
+        });
+    }
+    return SortedStream<T>(std::move(arr), bounds, blockSize);
+}
+
+/// <summary>
+///              policyMergeSort.
+/// </summary>
+/// <param name="numThreads"> .</param>
+/// <param name="size"> .</param>
+inline void compareSortedStream(size_t numThreads, size_t size = 20000000) {
+    std::vector<int> input = generateRandomArray<int, ThreadPolicy>(size, numThreads);
+    std::cout << "Sorted stream of " << size << " elements, Threads: " << numThreads << "\n";
+
+    std::vector<int> sorted = input;
+    auto start = std::chrono::high_resolution_clock::now();
+    policyMergeSort<ThreadPolicy>(sorted, numThreads);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::cout << "  policyMergeSort: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms\n";
+
+    start = std::chrono::high_resolution_clock::now();
+    SortedStream<int> stream = makeSortedStream<ThreadPolicy>(input, numThreads);
+    std::vector<int> block;
+    stream.next(block);
+    auto first = std::chrono::high_resolution_clock::now();
+    bool correct = std::equal(block.begin(), block.end(), sorted.begin());
+    size_t offset = block.size();
+    while (stream.next(block)) {
+        correct = correct && std::equal(block.begin(), block.end(), sorted.begin() + offset);
+        offset += block.size();
+    }
+    end = std::chrono::high_resolution_clock::now();
+    std::cout << "  first block: " << std::chrono::duration_cast<std::chrono::milliseconds>(first - start).count() << " ms"
+        << ", all blocks: " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms"
+        << (correct && offset == size ? "" : " WRONG RESULT") << "\n";
+}
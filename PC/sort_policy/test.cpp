@@ -0,0 +1,365 @@
+#include "pch.h"
+
+//       
+template <typename Policy>
+void expectPolicySorts(size_t size, size_t numThreads) {
+    std::vector<int> arr = generateRandomArray<int, Policy>(size, numThreads);
+    auto original = arr;
+    policyMergeSort<Policy>(arr, numThreads);
+    EXPECT_TRUE(isSorted(arr)) << ExecutionBackend<Policy>::name << ": array of " << size << " is not sorted";
+    std::sort(original.begin(), original.end());
+    EXPECT_EQ(arr, original) << ExecutionBackend<Policy>::name << ": result does not match std::sort";
+}
+
+//      
+TEST(PolicySortTest, AllPoliciesMatchStdSort) {
+    for (size_t size : { size_t(0), size_t(1), size_t(17), size_t(100003), size_t(2000000) }) {
+        expectPolicySorts<SerialPolicy>(size, 4);
+        expectPolicySorts<ThreadPolicy>(size, 4);
+#ifdef _OPENMP
+        expectPolicySorts<OpenMPPolicy>(size, 4);
+#endif
+#if SORT_POLICY_HAS_STD_PAR
+        expectPolicySorts<StdParPolicy>(size, 4);
+#endif
+    }
+}
+
+//        
+TEST(PolicyMergeTest, UnevenHalvesWithDuplicates) {
+    std::vector<int> arr(300000);
+    for (size_t i = 0; i < 100000; ++i) arr[i] = static_cast<int>(i / 7);
+    for (size_t i = 100000; i < arr.size(); ++i) arr[i] = static_cast<int>((i - 100000) / 13);
+    auto expected = arr;
+    std::sort(expected.begin(), expected.end());
+    std::vector<int> temp(arr.size());
+    policyMerge<ThreadPolicy>(arr, 0, 99999, arr.size() - 1, temp, 5);
+    EXPECT_EQ(arr, expected) << "Parallel merge does not match std::sort";
+}
+
+//   :   k    k 
+TEST(PolicyMergeTest, CoRankSplitsPrefix) {
+    std::vector<int> a = { 1, 2, 2, 5, 9 };
+    std::vector<int> b = { 2, 3, 4, 9 };
+    EXPECT_EQ(mergeCoRank(a.data(), a.size(), b.data(), b.size(), 0), size_t(0));
+    EXPECT_EQ(mergeCoRank(a.data(), a.size(), b.data(), b.size(), 3), size_t(3)); // 1, 2, 2  a
+    EXPECT_EQ(mergeCoRank(a.data(), a.size(), b.data(), b.size(), 6), size_t(3)); // + 2, 3, 4  b
+    EXPECT_EQ(mergeCoRank(a.data(), a.size(), b.data(), b.size(), 9), size_t(5));
+}
+
+//    
+TEST(PolicyGenerateTest, RangeAndSize) {
+    auto arr = generateRandomArray<float, ThreadPolicy>(10000, 4);
+    EXPECT_EQ(arr.size(), size_t(10000)) << "Array size does not match requested size";
+    for (const auto& val : arr) {
+        EXPECT_GE(val, -100.0f) << "Value below minimum range (-100.0)";
+        EXPECT_LE(val, 100.0f) << "Value above maximum range (100.0)";
+    }
+}
+
+//  / MessagePack   
+TEST(PolicyMsgpackIOTest, WriteAndReadInt) {
+    std::vector<int> original = generateRandomArray<int>(100000);
+    std::string filename = "test_policy.cbor";
+    EXPECT_TRUE(writeArrayMsgpack<ThreadPolicy>(original, filename, 4)) << "Failed to write Msgpack file";
+    std::vector<int> loaded;
+    EXPECT_TRUE(readArrayMsgpack<ThreadPolicy>(loaded, filename, 4)) << "Failed to read Msgpack file";
+    EXPECT_EQ(loaded, original) << "Loaded array does not match original";
+    std::vector<int> loadedAsync;
+    EXPECT_TRUE(readArrayMsgpackAsync<ThreadPolicy>(loadedAsync, filename, 4)) << "Failed to read Msgpack file asynchronously";
+    EXPECT_EQ(loadedAsync, original) << "Asynchronously loaded array does not match original";
+    std::remove(filename.c_str());
+}
+
+//    :          
+TEST(ScratchPoolTest, ReusesAndTrimsBuffers) {
+    ScratchPool& pool = ScratchPool::instance();
+    pool.trim(0);
+    ScratchPoolStats before = pool.stats();
+    void* first = nullptr;
+    {
+        ScratchBuffer<int> buffer(3000000);
+        first = buffer.data();
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(first) % 4096, 0u) << "Buffer is not page aligned";
+        for (size_t i = 0; i < buffer.size(); ++i) buffer[i] = static_cast<int>(i);
+    }
+    {
+        ScratchBuffer<int> buffer(2900000);
+        EXPECT_EQ(buffer.data(), first) << "Released buffer of a similar size must be reused";
+    }
+    ScratchPoolStats after = pool.stats();
+    EXPECT_EQ(after.acquires - before.acquires, 2u);
+    EXPECT_EQ(after.reuses - before.reuses, 1u);
+    EXPECT_GT(after.cachedBytes, 0u);
+    pool.trim(0);
+    EXPECT_EQ(pool.stats().cachedBytes, 0u) << "Trim must return free buffers to the system";
+}
+
+//   :          
+TEST(ScratchPoolTest, SortReportsPageFaults) {
+    std::vector<int> arr = generateRandomArray<int>(4000000);
+    std::vector<int> copy = arr;
+    SortTimings first, second;
+    policyMergeSort<ThreadPolicy>(arr, 4, &first);
+    policyMergeSort<ThreadPolicy>(copy, 4, &second);
+    EXPECT_TRUE(isSorted(arr));
+    EXPECT_EQ(arr, copy);
+#if SCRATCH_POOL_HAS_RUSAGE
+    EXPECT_GE(first.minorFaults, 0);
+    EXPECT_LE(second.minorFaults, first.minorFaults) << "Pooled scratch memory must not fault again";
+#endif
+}
+
+//   :          
+TEST(SegmentedSortTest, NetworksSortAllBinaryInputs) {
+    for (size_t n = 0; n <= segmentNetworkSize; ++n) {
+        for (uint32_t mask = 0; mask < (uint32_t(1) << n); ++mask) {
+            std::vector<int> arr(n);
+            for (size_t i = 0; i < n; ++i) arr[i] = (mask >> i) & 1;
+            sortTinySegment(arr.data(), n);
+            ASSERT_TRUE(isSorted(arr)) << "Network for " << n << " elements fails on mask " << mask;
+        }
+    }
+}
+
+//   : , ,    
+TEST(SegmentedSortTest, MatchesPerSegmentStdSort) {
+    std::mt19937 gen(7);
+    std::vector<size_t> offsets = { 0 };
+    for (size_t i = 0; i < 5000; ++i) {
+        size_t length = std::uniform_int_distribution<size_t>(0, 1000)(gen);
+        if (i % 1000 == 500) length = 300000; //   
+        offsets.push_back(offsets.back() + length);
+    }
+    std::vector<float> values = generateRandomArray<float>(offsets.back() + 10);
+    std::vector<float> expected = values;
+    for (size_t i = 0; i + 1 < offsets.size(); ++i) {
+        std::sort(expected.begin() + offsets[i], expected.begin() + offsets[i + 1]);
+    }
+
+    std::vector<float> serial = values;
+    ASSERT_TRUE(segmentedSort<SerialPolicy>(serial, offsets, 4));
+    EXPECT_EQ(serial, expected);
+    ASSERT_TRUE(segmentedSort<ThreadPolicy>(values, offsets, 4));
+    EXPECT_EQ(values, expected);
+}
+
+//    
+TEST(SegmentedSortTest, RejectsInvalidOffsets) {
+    std::vector<int> values = { 3, 2, 1 };
+    EXPECT_FALSE(segmentedSort<ThreadPolicy>(values, { 0, 2, 1 }, 2));
+    EXPECT_FALSE(segmentedSort<ThreadPolicy>(values, { 0, 4 }, 2));
+    EXPECT_EQ(values, std::vector<int>({ 3, 2, 1 }));
+    EXPECT_TRUE(segmentedSort<ThreadPolicy>(values, { 1, 3 }, 2));
+    EXPECT_EQ(values, std::vector<int>({ 3, 1, 2 }));
+}
+
+//   :     ,      
+TEST(QuantileSketchTest, RankErrorWithinBound) {
+    std::vector<float> arr = generateRandomArray<float, ThreadPolicy>(2000000, 4);
+    std::vector<float> sorted = arr;
+    std::sort(sorted.begin(), sorted.end());
+    size_t k = sketchKForError(0.01);
+    KllSketch<float> sketch = buildQuantileSketch<ThreadPolicy>(arr, 4, k);
+    EXPECT_EQ(sketch.size(), arr.size());
+    EXPECT_LE(sketch.rankError(), 0.01);
+    EXPECT_LT(sketch.retained(), arr.size() / 100) << "Sketch must keep a small sample";
+    EXPECT_EQ(sketch.quantile(0.0), sorted.front());
+    EXPECT_EQ(sketch.quantile(1.0), sorted.back());
+    for (double q : { 0.0, 0.01, 0.25, 0.5, 0.9, 0.99, 1.0 }) {
+        float value = sketch.quantile(q);
+        double trueRank = static_cast<double>(std::lower_bound(sorted.begin(), sorted.end(), value) - sorted.begin()) / arr.size();
+        EXPECT_NEAR(trueRank, q, 0.01) << "Quantile " << q;
+        EXPECT_NEAR(sketch.rank(value), trueRank, 0.01) << "Rank of quantile " << q;
+    }
+}
+
+//      ,    
+TEST(QuantileSketchTest, ExactQuantileMatchesSort) {
+    std::vector<int> ints = generateRandomArray<int, ThreadPolicy>(1000003, 4);
+    std::vector<float> floats = generateRandomArray<float, ThreadPolicy>(1000003, 4);
+    KllSketch<int> intSketch = buildQuantileSketch<ThreadPolicy>(ints, 4);
+    KllSketch<float> floatSketch = buildQuantileSketch<ThreadPolicy>(floats, 4);
+    std::vector<int> sortedInts = ints;
+    std::vector<float> sortedFloats = floats;
+    std::sort(sortedInts.begin(), sortedInts.end());
+    std::sort(sortedFloats.begin(), sortedFloats.end());
+    for (double q : { 0.0, 0.001, 0.5, 0.75, 0.999, 1.0 }) {
+        size_t index = static_cast<size_t>(q * (ints.size() - 1));
+        EXPECT_EQ(exactQuantile<ThreadPolicy>(ints, q, intSketch, 4), sortedInts[index]) << "Quantile " << q;
+        EXPECT_EQ(exactQuantile<ThreadPolicy>(floats, q, floatSketch, 4), sortedFloats[index]) << "Quantile " << q;
+    }
+    EXPECT_EQ(exactQuantile<SerialPolicy>(std::vector<int>{ 5 }, 0.5, KllSketch<int>(), 1), 5);
+}
+
+//     :         
+TEST(QuantileSketchTest, MergesSketchesOfDifferentSizes) {
+    std::vector<int> arr = generateRandomArray<int, ThreadPolicy>(1000003, 8);
+    std::vector<int> sorted = arr;
+    std::sort(sorted.begin(), sorted.end());
+    KllSketch<int> sketch = buildQuantileSketch<ThreadPolicy>(arr, 8);
+    EXPECT_EQ(sketch.size(), arr.size());
+
+    //      
+    std::vector<int> small(arr.begin(), arr.begin() + 3000);
+    for (int i = 0; i < 50; ++i) {
+        KllSketch<int> part(defaultSketchK, static_cast<uint32_t>(i + 100));
+        part.update(small.data(), small.size());
+        sketch.merge(part);
+        sorted.insert(sorted.end(), small.begin(), small.end());
+    }
+    std::sort(sorted.begin(), sorted.end());
+    EXPECT_EQ(sketch.size(), sorted.size());
+    for (double q : { 0.01, 0.25, 0.5, 0.75, 0.99 }) {
+        int value = sketch.quantile(q);
+        double trueRank = static_cast<double>(std::lower_bound(sorted.begin(), sorted.end(), value) - sorted.begin()) / sorted.size();
+        EXPECT_NEAR(trueRank, q, 2 * sketch.rankError()) << "Quantile " << q;
+    }
+}
+
+//   :       
+TEST(SortedStreamTest, BlocksMatchStdSort) {
+    for (size_t size : { size_t(0), size_t(1), size_t(5), size_t(100003) }) {
+        std::vector<float> arr = generateRandomArray<float>(size);
+        std::vector<float> expected = arr;
+        std::sort(expected.begin(), expected.end());
+        SortedStream<float> stream = makeSortedStream<ThreadPolicy>(arr, 4, 1000);
+        std::vector<float> result, block;
+        while (stream.next(block)) {
+            EXPECT_LE(block.size(), 1000u);
+            EXPECT_FALSE(block.empty());
+            result.insert(result.end(), block.begin(), block.end());
+        }
+        EXPECT_EQ(result, expected) << "Stream of " << size << " elements";
+        EXPECT_EQ(stream.remaining(), 0u);
+        EXPECT_FALSE(stream.next(block));
+    }
+}
+
+//   :   -  ,   
+TEST(SortedStreamTest, EarlyStopYieldsSmallestElements) {
+    std::vector<int> arr = generateRandomArray<int, ThreadPolicy>(1000000, 4);
+    std::vector<int> expected = arr;
+    std::sort(expected.begin(), expected.end());
+    SortedStream<int> stream = makeSortedStream<SerialPolicy>(arr, 4, 1);
+    std::vector<int> block;
+    for (size_t i = 0; i < 10; ++i) {
+        ASSERT_TRUE(stream.next(block));
+        ASSERT_EQ(block.size(), 1u);
+        EXPECT_EQ(block[0], expected[i]);
+    }
+    EXPECT_EQ(stream.remaining(), arr.size() - 10);
+}
+
+//         T
+template <typename T>
+void expectAlgorithmsSort(std::vector<T> arr) {
+    std::vector<T> expected = arr;
+    std::sort(expected.begin(), expected.end());
+    for (SortAlgorithm algorithm : { SortAlgorithm::Radix, SortAlgorithm::Sample }) {
+        for (size_t threads : { size_t(1), size_t(4) }) {
+            std::vector<T> sorted = arr;
+            sortWith<ThreadPolicy>(algorithm, sorted, threads);
+            EXPECT_EQ(sorted, expected) << algorithmName(algorithm) << ", " << threads << " threads, " << arr.size() << " elements";
+        }
+    }
+}
+
+//     : , ,  
+TEST(SortAlgorithmsTest, MatchStdSort) {
+    expectAlgorithmsSort(std::vector<int>{});
+    expectAlgorithmsSort(std::vector<int>{ 7 });
+    expectAlgorithmsSort(std::vector<int>(1000, 3));
+    expectAlgorithmsSort(generateRandomArray<int>(300001));
+    expectAlgorithmsSort(generateRandomArray<float>(300001));
+    std::mt19937_64 gen(3);
+    std::vector<long long> wide(200000);
+    for (auto& value : wide) value = static_cast<long long>(gen());
+    expectAlgorithmsSort(wide);
+    std::vector<double> doubles = { -0.0, 0.0, -1e300, 1e300, 2.5, -2.5, 1e-300, -1e-300 };
+    std::vector<double> sortedDoubles = doubles;
+    radixSort<SerialPolicy>(sortedDoubles, 1);
+    EXPECT_TRUE(std::is_sorted(sortedDoubles.begin(), sortedDoubles.end()));
+}
+
+//  :    ,    
+TEST(AutotuneTest, ProfileRoundTripAndAutoSort) {
+    SortProfile profile;
+    profile.tuning.maxThreads = 3;
+    profile.tuning.mergeGrain = 16384;
+    profile.tuning.ioBufferSize = 262144;
+    profile.classes = { { 1000, 1, SortAlgorithm::Sample }, { 100000, 2, SortAlgorithm::Radix } };
+    const std::string filename = "test_sort_profile.txt";
+    ASSERT_TRUE(saveSortProfile(profile, filename));
+    SortProfile loaded;
+    ASSERT_TRUE(loadSortProfile(loaded, filename));
+    std::remove(filename.c_str());
+    EXPECT_EQ(loaded.tuning.maxThreads, 3u);
+    EXPECT_EQ(loaded.tuning.mergeGrain, 16384u);
+    EXPECT_EQ(loaded.tuning.ioBufferSize, 262144u);
+    ASSERT_EQ(loaded.classes.size(), 2u);
+    EXPECT_EQ(loaded.classes[1].algorithm, SortAlgorithm::Radix);
+    EXPECT_EQ(loaded.classes[1].threads, 2u);
+
+    SortTuning previous = sortTuning;
+    applySortProfile(loaded);
+    EXPECT_EQ(sortTuning.mergeGrain, 16384u);
+    for (size_t size : { size_t(500), size_t(50000), size_t(500000) }) {
+        std::vector<int> arr = generateRandomArray<int>(size);
+        autoSort(arr);
+        EXPECT_TRUE(isSorted(arr)) << size;
+    }
+    applySortProfile(SortProfile());
+    sortTuning = previous;
+
+    for (const char* bad : { "class 10 0 merge\n", "mergeGrain 0\n", "maxThreads -2\n", "ioBufferSize 4096 bytes\n" }) {
+        std::ofstream("bad_sort_profile.txt") << bad;
+        EXPECT_FALSE(loadSortProfile(loaded, "bad_sort_profile.txt")) << bad;
+    }
+    std::remove("bad_sort_profile.txt");
+}
+
+//    :   -   ,    
+TEST(AutotuneTest, ThreadCountInputUsesProfileLimit) {
+    SortTuning previous = sortTuning;
+    SortProfile profile;
+    profile.tuning.maxThreads = 4;
+    profile.classes = { { 1000, 1, SortAlgorithm::Radix }, { 100000, 3, SortAlgorithm::Sample } };
+    applySortProfile(profile);
+
+    size_t numThreads = 7;
+    std::istringstream input("\n  \n4\n 2 \n5\n0\nabc\n3 x\n");
+    EXPECT_TRUE(readThreadCount(input, numThreads));
+    EXPECT_EQ(numThreads, 0u);
+    EXPECT_TRUE(readThreadCount(input, numThreads));
+    EXPECT_EQ(numThreads, 0u);
+    EXPECT_TRUE(readThreadCount(input, numThreads));
+    EXPECT_EQ(numThreads, 4u);
+    EXPECT_TRUE(readThreadCount(input, numThreads));
+    EXPECT_EQ(numThreads, 2u);
+    for (int i = 0; i < 4; ++i) {
+        EXPECT_FALSE(readThreadCount(input, numThreads)) << i;
+    }
+    EXPECT_FALSE(readThreadCount(input, numThreads)) << "End of input must not count as a choice";
+
+    EXPECT_EQ(chooseSortClass(500).algorithm, SortAlgorithm::Radix);
+    EXPECT_EQ(chooseSortClass(50000).threads, 3u);
+    EXPECT_EQ(chooseSortClass(5000000).algorithm, SortAlgorithm::Sample) << "Large arrays use the last class";
+
+    applySortProfile(SortProfile());
+    sortTuning = previous;
+    EXPECT_EQ(chooseSortClass(500).algorithm, SortAlgorithm::Merge);
+}
+
+//     :     ,   
+TEST(AutotuneTest, CalibrationProducesClasses) {
+    SortTuning previous = sortTuning;
+    SortProfile profile = calibrateSortProfile({ 1000, 20000 }, 2);
+    ASSERT_EQ(profile.classes.size(), 2u);
+    EXPECT_EQ(profile.classes[0].maxSize, 1000u);
+    EXPECT_LE(profile.classes[1].threads, 2u);
+    EXPECT_EQ(profile.tuning.maxThreads, std::max(profile.classes[0].threads, profile.classes[1].threads))
+        << "Thread limit must come from the measured classes";
+    EXPECT_GT(profile.tuning.ioBufferSize, 0u);
+    EXPECT_EQ(sortTuning.maxThreads, previous.maxThreads) << "Calibration must restore the active thresholds";
+}